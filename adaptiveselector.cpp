@@ -0,0 +1,155 @@
+#include "adaptiveselector.h"
+
+#include <algorithm>
+
+void AdaptiveSelector::build(const QVector<ItemParameters> &items)
+{
+    parameters = items;
+    bandOf.resize(items.size());
+    positionOf.resize(items.size());
+
+    float minA = 0.0f;
+    float maxA = 0.0f;
+    for (int i = 0; i < items.size(); ++i) {
+        minA = i == 0 ? items[i].a : std::min(minA, items[i].a);
+        maxA = i == 0 ? items[i].a : std::max(maxA, items[i].a);
+    }
+    const float width = (maxA - minA) / kBands;
+
+    for (Band &band : bands)
+        band.questions.clear();
+    for (int i = 0; i < items.size(); ++i) {
+        const int index = width > 0 ? std::min(kBands - 1, int((items[i].a - minA) / width)) : 0;
+        bandOf[i] = quint8(index);
+        bands[index].questions.append(i);
+    }
+
+    for (Band &band : bands) {
+        std::sort(band.questions.begin(), band.questions.end(), [&](int x, int y) {
+            return items[x].b < items[y].b || (items[x].b == items[y].b && x < y);
+        });
+        band.difficulty.resize(band.questions.size());
+        band.minA = band.maxA = band.questions.isEmpty() ? 1.0f : items[band.questions[0]].a;
+        for (int k = 0; k < band.questions.size(); ++k) {
+            const ItemParameters &item = items[band.questions[k]];
+            band.difficulty[k] = item.b;
+            band.minA = std::min(band.minA, item.a);
+            band.maxA = std::max(band.maxA, item.a);
+            positionOf[band.questions[k]] = k;
+        }
+        band.leaves = 1;
+        while (band.leaves < band.questions.size())
+            band.leaves *= 2;
+    }
+    reset();
+}
+
+void AdaptiveSelector::reset()
+{
+    free = parameters.size();
+    for (Band &band : bands) {
+        band.tree.fill(0, 2 * band.leaves);
+        for (int k = 0; k < band.questions.size(); ++k)
+            band.tree[band.leaves + k] = 1;
+        for (int node = band.leaves - 1; node > 0; --node)
+            band.tree[node] = band.tree[2 * node] + band.tree[2 * node + 1];
+    }
+}
+
+int AdaptiveSelector::Band::firstFree(int from) const
+{
+    if (from >= questions.size())
+        return -1;
+    int node = leaves + from;
+    if (tree[node] == 0) {
+        // Вверх, пока не найдётся правый сосед со свободными, затем вниз к крайнему левому
+        for (;;) {
+            if (node == 1)
+                return -1;
+            if ((node & 1) == 0 && tree[node + 1] > 0) {
+                ++node;
+                break;
+            }
+            node /= 2;
+        }
+        while (node < leaves)
+            node = tree[2 * node] > 0 ? 2 * node : 2 * node + 1;
+    }
+    return node - leaves;
+}
+
+int AdaptiveSelector::Band::lastFreeBefore(int to) const
+{
+    if (to <= 0)
+        return -1;
+    int node = leaves + to - 1;
+    if (tree[node] == 0) {
+        for (;;) {
+            if (node == 1)
+                return -1;
+            if ((node & 1) == 1 && tree[node - 1] > 0) {
+                --node;
+                break;
+            }
+            node /= 2;
+        }
+        while (node < leaves)
+            node = tree[2 * node + 1] > 0 ? 2 * node + 1 : 2 * node;
+    }
+    return node - leaves;
+}
+
+int AdaptiveSelector::next(double theta) const
+{
+    int best = -1;
+    double bestInformation = -1.0;
+    // Полосы с большим a первыми: они быстрее дают высокую планку для отсечения
+    for (int index = kBands - 1; index >= 0; --index) {
+        const Band &band = bands[index];
+        if (band.questions.isEmpty() || band.tree[1] == 0)
+            continue;
+        const int split = int(std::lower_bound(band.difficulty.cbegin(), band.difficulty.cend(), float(theta))
+                              - band.difficulty.cbegin());
+        int left = band.lastFreeBefore(split);
+        int right = band.firstFree(split);
+
+        // Обход от θ наружу по возрастанию |b − θ|. Информация не больше
+        // maxA²·w(minA·|b − θ|), где w(z) = σ(z)(1 − σ(z)) убывает с |z|, поэтому
+        // как только эта граница не выше найденного, дальше в полосе искать нечего.
+        while (left >= 0 || right >= 0) {
+            const bool takeLeft = right < 0
+                || (left >= 0 && theta - band.difficulty[left] <= band.difficulty[right] - theta);
+            const int position = takeLeft ? left : right;
+            ItemParameters bound;
+            bound.a = band.minA;
+            bound.b = band.difficulty[position];
+            const double limit = Irt::information(bound, theta) * (double(band.maxA) * band.maxA)
+                                 / (double(band.minA) * band.minA);
+            if (limit <= bestInformation)
+                break;
+
+            const int question = band.questions[position];
+            const double information = Irt::information(parameters[question], theta);
+            if (information > bestInformation) {
+                bestInformation = information;
+                best = question;
+            }
+            if (takeLeft)
+                left = band.lastFreeBefore(left);
+            else
+                right = band.firstFree(right + 1);
+        }
+    }
+    return best;
+}
+
+void AdaptiveSelector::take(int question)
+{
+    Band &band = bands[bandOf[question]];
+    int node = band.leaves + positionOf[question];
+    if (band.tree[node] == 0)
+        return;
+    for (; node > 0; node /= 2)
+        --band.tree[node];
+    --free;
+}
@@ -0,0 +1,53 @@
+#ifndef ADAPTIVESELECTOR_H
+#define ADAPTIVESELECTOR_H
+
+#include <QVector>
+
+#include "irtmodel.h"
+
+// Выбор следующего вопроса адаптивного теста — вопроса с наибольшей
+// информацией при текущей оценке уровня. Вопросы разложены по kBands полосам
+// различающей способности a, внутри полосы отсортированы по трудности b.
+// При одинаковом a информация 2PL максимальна при b = θ и убывает с |b − θ|,
+// поэтому полоса просматривается от θ наружу и бросается, как только верхняя
+// граница информации для её разброса a опускается ниже лучшего найденного.
+// Соседние свободные вопросы находит дерево отрезков над счётчиками
+// свободных. Выбор точный и обычно просматривает единицы вопросов на полосу:
+// O(kBands · log n) вместо просмотра всего банка.
+class AdaptiveSelector
+{
+public:
+    static constexpr int kBands = 32;
+
+    void build(const QVector<ItemParameters> &items);
+    // Все вопросы снова свободны; сортировка сохраняется
+    void reset();
+
+    // Номер вопроса или -1, если свободных не осталось
+    int next(double theta) const;
+    void take(int question);
+
+    int available() const { return free; }
+
+private:
+    struct Band
+    {
+        QVector<int> questions;     // по возрастанию b
+        QVector<float> difficulty;  // b тех же вопросов, для двоичного поиска
+        QVector<int> tree;          // свободные в поддеревьях; листья с позиции leaves
+        int leaves = 1;
+        float minA = 1.0f;
+        float maxA = 1.0f;
+
+        int firstFree(int from) const;
+        int lastFreeBefore(int to) const;
+    };
+
+    QVector<ItemParameters> parameters;
+    QVector<quint8> bandOf;
+    QVector<int> positionOf;
+    Band bands[kBands];
+    int free = 0;
+};
+
+#endif // ADAPTIVESELECTOR_H
@@ -0,0 +1,54 @@
+#include <QCoreApplication>
+#include <QImage>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtEndian>
+
+// AssetBaker <вход> <выход> <ширина> <высота> — шаг сборки: картинка
+// заранее масштабируется (KeepAspectRatio, SmoothTransformation) и
+// сохраняется несжатыми пикселями ARGB32 Premultiplied, чтобы приложение
+// при запуске не декодировало JPEG и не масштабировало его.
+//
+// Формат: "MSIM", затем u32 little-endian ширина, высота, байт на строку,
+// QImage::Format; с 20-го байта — строки пикселей.
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    const QStringList args = app.arguments();
+    if (args.size() != 5) {
+        err << "Использование: AssetBaker <вход> <выход> <ширина> <высота>\n";
+        return 2;
+    }
+
+    QImage image(args[1]);
+    if (image.isNull()) {
+        err << "Не удалось прочитать " << args[1] << "\n";
+        return 1;
+    }
+    image = image.scaled(args[3].toInt(), args[4].toInt(), Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    QByteArray header("MSIM");
+    for (quint32 value : {quint32(image.width()), quint32(image.height()),
+                          quint32(image.bytesPerLine()), quint32(image.format())}) {
+        char bytes[4];
+        qToLittleEndian(value, bytes);
+        header.append(bytes, 4);
+    }
+
+    QSaveFile out(args[2]);
+    if (!out.open(QIODevice::WriteOnly)) {
+        err << "Не удалось создать " << args[2] << ": " << out.errorString() << "\n";
+        return 1;
+    }
+    out.write(header);
+    out.write(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes());
+    if (!out.commit()) {
+        err << "Не удалось записать " << args[2] << ": " << out.errorString() << "\n";
+        return 1;
+    }
+    return 0;
+}
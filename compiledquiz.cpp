@@ -0,0 +1,123 @@
+#include "compiledquiz.h"
+#include "quizsource.h"
+#include "scoring.h"
+
+#include <cstring>
+
+qsizetype CompiledQuiz::arenaSize(int capacity)
+{
+    // Текст, 4 варианта, префикс времени (capacity + 1), маска и сложность
+    return qsizetype(capacity) * (4 + 16 + 4 + 1 + 1) + 4;
+}
+
+void CompiledQuiz::clear()
+{
+    arena.clear();
+    size = 0;
+    capacity = 0;
+    strings.clear();
+    stringIds.clear();
+}
+
+void CompiledQuiz::reserve(int newCapacity)
+{
+    if (newCapacity <= capacity)
+        return;
+
+    // Столбцы переносятся целиком при удвоении, поэтому добавление вопросов
+    // при потоковой загрузке стоит амортизированно O(1) и почти без выделений
+    CompiledQuiz grown;
+    grown.capacity = newCapacity;
+    grown.arena.fill(0, arenaSize(newCapacity));
+    if (size > 0) {
+        std::memcpy(grown.textIds(), textIds(), size * sizeof(quint32));
+        std::memcpy(grown.optionIds(), optionIds(), 4 * size * sizeof(quint32));
+        std::memcpy(grown.budgets(), budgets(), (size + 1) * sizeof(qint32));
+        std::memcpy(grown.masks(), masks(), size);
+        std::memcpy(grown.difficulties(), difficulties(), size);
+    }
+    arena.swap(grown.arena);
+    capacity = newCapacity;
+}
+
+void CompiledQuiz::grow(int count)
+{
+    if (count + size > capacity)
+        reserve(qMax(count + size, capacity * 2));
+}
+
+void CompiledQuiz::setBudget(int index, int difficulty)
+{
+    difficulties()[index] = difficulty;
+    budgets()[index + 1] = budgets()[index] + Scoring::secondsFor(difficulty);
+}
+
+void CompiledQuiz::fill(int index, const Question &question)
+{
+    auto intern = [this](const QString &text) -> quint32 {
+        auto it = stringIds.constFind(text);
+        if (it != stringIds.constEnd())
+            return it.value();
+        const quint32 id = strings.size();
+        stringIds.insert(text, id);
+        strings.append(text);
+        return id;
+    };
+
+    textIds()[index] = intern(question.text);
+    for (int k = 0; k < Question::kOptionCount; ++k)
+        optionIds()[4 * index + k] = intern(question.options[k]);
+    masks()[index] = question.correctMask;
+}
+
+void CompiledQuiz::append(const QuizSource &source, int first, int last)
+{
+    if (last <= first)
+        return;
+    grow(last - first);
+
+    for (int i = first; i < last; ++i) {
+        const Question q = source.question(i);
+        fill(size, q);
+        setBudget(size, q.difficulty);
+        ++size;
+    }
+}
+
+void CompiledQuiz::appendLazy(const QuizSource &source, int first, int last)
+{
+    if (last <= first)
+        return;
+    grow(last - first);
+
+    // Сложность в *.quizbin лежит отдельным столбцом и читается без распаковки блоков
+    for (int i = first; i < last; ++i) {
+        textIds()[size] = kNotCompiled;
+        setBudget(size, source.difficulty(i));
+        ++size;
+    }
+}
+
+void CompiledQuiz::compile(const QuizSource &source, int index)
+{
+    if (index < 0 || index >= size || isCompiled(index))
+        return;
+    fill(index, source.question(index));
+}
+
+const QString &CompiledQuiz::option(int index, int option) const
+{
+    return strings[optionIds()[4 * index + option]];
+}
+
+int CompiledQuiz::points(int index, quint8 answerMask) const
+{
+    return Scoring::points(correctMask(index), difficulty(index), answerMask);
+}
+
+int CompiledQuiz::timeBudget(int first, int last) const
+{
+    if (last <= first)
+        return 0;
+    return budgets()[last] - budgets()[first];
+}
@@ -0,0 +1,71 @@
+#ifndef COMPILEDQUIZ_H
+#define COMPILEDQUIZ_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
+
+#include "question.h"
+
+class QuizSource;
+
+// Викторина, скомпилированная для прохождения: столбцы (ссылки на строки,
+// маски правильных ответов, сложности, префиксные суммы времени) лежат в
+// одном буфере-арене, строки хранятся один раз в пуле. Показ вопроса,
+// проверка ответа и подсчёт времени не выделяют память.
+//
+// Для скомпилированного файла вопросы добавляются без текста (appendLazy):
+// сложности и время известны сразу, а текст, варианты и ключ вопроса
+// распаковываются из источника только для тех вопросов, которые попали в план
+// и показываются (compile). Обращаться к тексту, вариантам и ключу можно
+// только после compile.
+class CompiledQuiz
+{
+public:
+    void clear();
+    void append(const QuizSource &source, int first, int last);
+    void appendLazy(const QuizSource &source, int first, int last);
+    void compile(const QuizSource &source, int index);
+    bool isCompiled(int index) const { return textIds()[index] != kNotCompiled; }
+
+    int count() const { return size; }
+    const QString &text(int index) const { return strings[textIds()[index]]; }
+    const QString &option(int index, int option) const;
+    quint8 correctMask(int index) const { return masks()[index]; }
+    quint8 difficulty(int index) const { return difficulties()[index]; }
+
+    int points(int index, quint8 answerMask) const;
+    int timeBudget(int first, int last) const;
+
+private:
+    static constexpr quint32 kNotCompiled = 0xffffffffu;
+
+    void reserve(int capacity);
+    void grow(int count);
+    void setBudget(int index, int difficulty);
+    void fill(int index, const Question &question);
+
+    // Смещения столбцов в арене при текущей ёмкости
+    quint32 *textIds() { return reinterpret_cast<quint32 *>(arena.data()); }
+    const quint32 *textIds() const { return reinterpret_cast<const quint32 *>(arena.constData()); }
+    quint32 *optionIds() { return textIds() + capacity; }
+    const quint32 *optionIds() const { return textIds() + capacity; }
+    qint32 *budgets() { return reinterpret_cast<qint32 *>(optionIds() + 4 * capacity); }
+    const qint32 *budgets() const { return reinterpret_cast<const qint32 *>(optionIds() + 4 * capacity); }
+    quint8 *masks() { return reinterpret_cast<quint8 *>(budgets() + capacity + 1); }
+    const quint8 *masks() const { return reinterpret_cast<const quint8 *>(budgets() + capacity + 1); }
+    quint8 *difficulties() { return masks() + capacity; }
+    const quint8 *difficulties() const { return masks() + capacity; }
+
+    static qsizetype arenaSize(int capacity);
+
+    QByteArray arena;
+    int size = 0;
+    int capacity = 0;
+
+    QVector<QString> strings;
+    QHash<QString, quint32> stringIds;
+};
+
+#endif // COMPILEDQUIZ_H
@@ -0,0 +1,188 @@
+#include "duplicateindex.h"
+#include "searchindex.h"
+
+#include <QStringList>
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace {
+
+const int kShingle = 4;
+// Сколько предыдущих членов корзины сравнивается с очередным при разбиении
+// на группы: большие корзины из одинаковых вопросов не дают квадрата
+const int kBucketWindow = 32;
+
+quint64 splitMix(quint64 &state)
+{
+    quint64 z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Хеш-функции вида (a*x + b) >> 32 с нечётным a; константы постоянны,
+// чтобы подписи не зависели от запуска
+struct Permutations
+{
+    std::array<quint64, DuplicateIndex::kHashes> a;
+    std::array<quint64, DuplicateIndex::kHashes> b;
+
+    Permutations()
+    {
+        quint64 state = 0x5175697a44757073ull;
+        for (int i = 0; i < DuplicateIndex::kHashes; ++i) {
+            a[i] = splitMix(state) | 1;
+            b[i] = splitMix(state);
+        }
+    }
+};
+
+const Permutations &permutations()
+{
+    static const Permutations instance;
+    return instance;
+}
+
+quint64 fnv1a(const QChar *data, int length)
+{
+    quint64 hash = 0xcbf29ce484222325ull;
+    for (int i = 0; i < length; ++i) {
+        hash ^= data[i].unicode();
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+QString normalized(const Question &question)
+{
+    QStringList options;
+    for (const QString &option : question.options)
+        options << SearchIndex::tokenize(option).join(' ');
+    options.sort();
+    return SearchIndex::tokenize(question.text).join(' ') + " | " + options.join(" | ");
+}
+
+int findRoot(QVector<int> &parent, int x)
+{
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+void DuplicateIndex::clear()
+{
+    ids.clear();
+    signatures.clear();
+    buckets.clear();
+}
+
+void DuplicateIndex::reserve(int count)
+{
+    ids.reserve(count);
+    signatures.reserve(qsizetype(count) * kHashes);
+}
+
+DuplicateIndex::Signature DuplicateIndex::signatureOf(const Question &question)
+{
+    const QString text = normalized(question);
+    const Permutations &perm = permutations();
+    Signature signature(kHashes, 0xffffffffu);
+
+    const int last = qMax(0, text.size() - kShingle);
+    for (int pos = 0; pos <= last; ++pos) {
+        const quint64 x = fnv1a(text.constData() + pos, qMin(kShingle, int(text.size())));
+        for (int i = 0; i < kHashes; ++i)
+            signature[i] = qMin(signature[i], quint32((x * perm.a[i] + perm.b[i]) >> 32));
+    }
+    return signature;
+}
+
+quint64 DuplicateIndex::bandKey(const quint32 *signature, int band)
+{
+    quint64 key = quint64(band) * 0x9e3779b97f4a7c15ull;
+    for (int r = 0; r < kRows; ++r)
+        key = (key ^ signature[band * kRows + r]) * 0x100000001b3ull;
+    return key;
+}
+
+double DuplicateIndex::similarity(const quint32 *a, const quint32 *b)
+{
+    int equal = 0;
+    for (int i = 0; i < kHashes; ++i)
+        equal += a[i] == b[i];
+    return double(equal) / kHashes;
+}
+
+void DuplicateIndex::add(int id, const Question &question)
+{
+    const Signature signature = signatureOf(question);
+    const int slot = ids.size();
+    ids.append(id);
+    signatures += signature;
+    for (int band = 0; band < kBands; ++band)
+        buckets[bandKey(signature.constData(), band)].append(slot);
+}
+
+QVector<DuplicateIndex::Match> DuplicateIndex::findSimilar(const Question &question, double threshold) const
+{
+    const Signature signature = signatureOf(question);
+
+    QVector<int> candidates;
+    for (int band = 0; band < kBands; ++band) {
+        const auto it = buckets.constFind(bandKey(signature.constData(), band));
+        if (it != buckets.constEnd())
+            candidates += it.value();
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    QVector<Match> matches;
+    for (int slot : candidates) {
+        const double s = similarity(signature.constData(), signatureAt(slot));
+        if (s >= threshold)
+            matches.append({ids[slot], s});
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        return a.similarity > b.similarity || (a.similarity == b.similarity && a.id < b.id);
+    });
+    return matches;
+}
+
+QVector<QVector<int>> DuplicateIndex::clusters(double threshold) const
+{
+    QVector<int> parent(ids.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    for (auto it = buckets.constBegin(); it != buckets.constEnd(); ++it) {
+        const QVector<int> &members = it.value();
+        for (int i = 1; i < members.size(); ++i) {
+            for (int j = qMax(0, i - kBucketWindow); j < i; ++j) {
+                const int a = findRoot(parent, members[i]);
+                const int b = findRoot(parent, members[j]);
+                if (a != b && similarity(signatureAt(members[i]), signatureAt(members[j])) >= threshold)
+                    parent[qMax(a, b)] = qMin(a, b);
+            }
+        }
+    }
+
+    QHash<int, QVector<int>> groups;
+    for (int slot = 0; slot < ids.size(); ++slot)
+        groups[findRoot(parent, slot)].append(ids[slot]);
+
+    QVector<QVector<int>> result;
+    for (QVector<int> &group : groups) {
+        if (group.size() < 2)
+            continue;
+        std::sort(group.begin(), group.end());
+        result.append(group);
+    }
+    std::sort(result.begin(), result.end(), [](const QVector<int> &a, const QVector<int> &b) {
+        return a.first() < b.first();
+    });
+    return result;
+}
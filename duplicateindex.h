@@ -0,0 +1,55 @@
+#ifndef DUPLICATEINDEX_H
+#define DUPLICATEINDEX_H
+
+#include <QHash>
+#include <QVector>
+
+#include "question.h"
+
+// Поиск почти одинаковых вопросов. Текст вопроса и вариантов (без учёта
+// порядка вариантов) нормализуется так же, как для поиска, и разбивается на
+// перекрывающиеся четвёрки символов. По ним строится подпись MinHash из
+// kHashes чисел: доля совпавших чисел двух подписей оценивает сходство
+// Жаккара множеств четвёрок. Подписи разбиты на kBands полос; вопросы с
+// совпавшей полосой попадают в одну корзину, и сравниваются только они,
+// поэтому время растёт почти линейно с размером банка.
+class DuplicateIndex
+{
+public:
+    static const int kHashes = 64;
+    static const int kBands = 16;
+    static const int kRows = kHashes / kBands;
+
+    struct Match
+    {
+        int id;
+        double similarity;
+    };
+
+    void clear();
+    void reserve(int count);
+    void add(int id, const Question &question);
+    int count() const { return ids.size(); }
+
+    // Похожие на question вопросы индекса, по убыванию сходства
+    QVector<Match> findSimilar(const Question &question, double threshold) const;
+
+    // Группы похожих вопросов банка (не меньше двух в группе), номера по возрастанию
+    QVector<QVector<int>> clusters(double threshold) const;
+
+private:
+    using Signature = QVector<quint32>;
+
+    static Signature signatureOf(const Question &question);
+    static quint64 bandKey(const quint32 *signature, int band);
+    static double similarity(const quint32 *a, const quint32 *b);
+
+    const quint32 *signatureAt(int slot) const { return signatures.constData() + qsizetype(slot) * kHashes; }
+
+    QVector<int> ids;
+    QVector<quint32> signatures;
+    // Ключ полосы -> позиции в ids
+    QHash<quint64, QVector<int>> buckets;
+};
+
+#endif // DUPLICATEINDEX_H
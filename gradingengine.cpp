@@ -0,0 +1,107 @@
+#include "gradingengine.h"
+#include "quizsource.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QtEndian>
+
+namespace {
+
+const quint64 kLow7 = 0x7f7f7f7f7f7f7f7fULL;
+const quint64 kHigh = 0x8080808080808080ULL;
+const quint64 kOnes = 0x0101010101010101ULL;
+
+// Бланков на одну задачу пула: меньше — накладные расходы на задачи заметнее самой проверки
+const int kMinSheetsPerTask = 4096;
+
+quint64 load64(const uchar *ptr)
+{
+    return qFromUnaligned<quint64>(ptr);
+}
+
+} // namespace
+
+GradingEngine::GradingEngine(const QuizSource &quiz)
+    : count(quiz.count())
+{
+    const int padded = (count + 7) & ~7;
+    key.fill(0, padded);
+    weights.fill(0, padded);
+
+    for (int i = 0; i < count; ++i) {
+        const Question q = quiz.question(i);
+        key[i] = static_cast<char>(q.correctMask);
+        weights[i] = static_cast<char>(q.difficulty);
+        total += q.difficulty;
+        // Сумма восьми весов должна помещаться в байт
+        packedWeights = packedWeights && q.difficulty <= 31;
+    }
+}
+
+int GradingEngine::gradeScalar(const uchar *sheet) const
+{
+    const uchar *correct = reinterpret_cast<const uchar *>(key.constData());
+    const uchar *weight = reinterpret_cast<const uchar *>(weights.constData());
+    int score = 0;
+    for (int i = 0; i < count; ++i) {
+        if (sheet[i] == correct[i])
+            score += weight[i];
+    }
+    return score;
+}
+
+int GradingEngine::grade(const uchar *sheet) const
+{
+    if (!packedWeights)
+        return gradeScalar(sheet);
+
+    const uchar *correct = reinterpret_cast<const uchar *>(key.constData());
+    const uchar *weight = reinterpret_cast<const uchar *>(weights.constData());
+    int score = 0;
+    for (int i = 0; i < key.size(); i += 8) {
+        const quint64 diff = load64(sheet + i) ^ load64(correct + i);
+        // Старший бит байта взведён, если в байте есть хоть один ненулевой бит
+        const quint64 nonZero = (((diff & kLow7) + kLow7) | diff) & kHigh;
+        const quint64 equal = ((nonZero ^ kHigh) >> 7) * 0xff;
+        // Горизонтальная сумма байтов: старший байт произведения на 0x0101...01
+        score += int(((load64(weight + i) & equal) * kOnes) >> 56);
+    }
+    return score;
+}
+
+QVector<int> GradingEngine::gradeBatch(const QByteArray &sheets) const
+{
+    const int sheetCount = stride() > 0 ? sheets.size() / stride() : 0;
+    QVector<int> scores(sheetCount);
+    if (sheetCount == 0)
+        return scores;
+
+    const uchar *data = reinterpret_cast<const uchar *>(sheets.constData());
+    int *out = scores.data();
+    auto gradeRange = [this, data, out](int first, int last) {
+        for (int i = first; i < last; ++i)
+            out[i] = grade(data + qsizetype(i) * stride());
+    };
+
+    const int tasks = qMin(QThread::idealThreadCount(), sheetCount / kMinSheetsPerTask);
+    if (tasks <= 1) {
+        gradeRange(0, sheetCount);
+        return scores;
+    }
+
+    // Каждая задача пишет в свой непересекающийся диапазон результатов
+    QSemaphore done;
+    const int perTask = (sheetCount + tasks - 1) / tasks;
+    int started = 0;
+    for (int first = 0; first < sheetCount; first += perTask) {
+        const int last = qMin(first + perTask, sheetCount);
+        QThreadPool::globalInstance()->start([&gradeRange, &done, first, last]() {
+            gradeRange(first, last);
+            done.release();
+        });
+        ++started;
+    }
+    done.acquire(started);
+    return scores;
+}
@@ -0,0 +1,34 @@
+#ifndef GRADINGENGINE_H
+#define GRADINGENGINE_H
+
+#include <QByteArray>
+#include <QVector>
+
+class QuizSource;
+
+// Пакетная проверка бланков ответов. Бланк — байтовая маска выбранных
+// вариантов на каждый вопрос (бит i — вариант i в порядке файла), бланки
+// лежат подряд с шагом stride(). Ключ и веса выровнены до 8 байт, поэтому
+// за одно сравнение 64-битных слов проверяются сразу восемь вопросов.
+class GradingEngine
+{
+public:
+    explicit GradingEngine(const QuizSource &quiz);
+
+    int questionCount() const { return count; }
+    int stride() const { return key.size(); }
+    int maxScore() const { return total; }
+
+    int grade(const uchar *sheet) const;
+    int gradeScalar(const uchar *sheet) const;
+    QVector<int> gradeBatch(const QByteArray &sheets) const;
+
+private:
+    QByteArray key;
+    QByteArray weights;
+    int count = 0;
+    int total = 0;
+    bool packedWeights = true;
+};
+
+#endif // GRADINGENGINE_H
@@ -0,0 +1,62 @@
+#include "irtmodel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// log σ(z) без переполнения при больших |z|
+double logSigmoid(double z)
+{
+    return z >= 0 ? -std::log1p(std::exp(-z)) : z - std::log1p(std::exp(z));
+}
+
+} // namespace
+
+ItemParameters Irt::prior(int difficulty)
+{
+    // Лёгкий, средний, сложный — на стандартное отклонение ниже, на уровне и выше среднего
+    ItemParameters item;
+    item.b = difficulty >= 1 && difficulty <= 3 ? float(difficulty - 2) : 0.0f;
+    return item;
+}
+
+double Irt::probability(const ItemParameters &item, double theta)
+{
+    return 1.0 / (1.0 + std::exp(-item.a * (theta - item.b)));
+}
+
+double Irt::information(const ItemParameters &item, double theta)
+{
+    const double p = probability(item, theta);
+    return double(item.a) * item.a * p * (1.0 - p);
+}
+
+AbilityEstimate::AbilityEstimate()
+{
+    for (int i = 0; i < kPoints; ++i)
+        logPosterior[i] = -0.5 * point(i) * point(i);
+}
+
+void AbilityEstimate::update(const ItemParameters &item, bool correct)
+{
+    double top = -HUGE_VAL;
+    for (int i = 0; i < kPoints; ++i) {
+        const double z = item.a * (point(i) - item.b);
+        logPosterior[i] += correct ? logSigmoid(z) : logSigmoid(-z);
+        top = std::max(top, logPosterior[i]);
+    }
+
+    double total = 0.0;
+    double sum = 0.0;
+    double squares = 0.0;
+    for (int i = 0; i < kPoints; ++i) {
+        const double weight = std::exp(logPosterior[i] - top);
+        total += weight;
+        sum += weight * point(i);
+        squares += weight * point(i) * point(i);
+    }
+    mean = sum / total;
+    deviation = std::sqrt(std::max(0.0, squares / total - mean * mean));
+    ++answered;
+}
@@ -0,0 +1,54 @@
+#ifndef IRTMODEL_H
+#define IRTMODEL_H
+
+#include <QtGlobal>
+
+// Параметры вопроса в двухпараметрической логистической модели (2PL):
+// вероятность верного ответа участника уровня θ равна 1 / (1 + e^(−a(θ − b))),
+// где b — трудность в той же шкале, что и θ, a — различающая способность.
+struct ItemParameters
+{
+    float a = 1.0f;
+    float b = 0.0f;
+    int responses = 0;      // по скольким ответам откалиброван; 0 — априорные значения
+};
+
+namespace Irt
+{
+// Априорные параметры по полю сложности 1–3, пока у вопроса нет истории
+ItemParameters prior(int difficulty);
+
+double probability(const ItemParameters &item, double theta);
+// Информация Фишера a²·P·(1 − P): насколько ответ на вопрос уточняет θ
+double information(const ItemParameters &item, double theta);
+}
+
+// Оценка уровня участника методом EAP: апостериорное распределение θ хранится
+// на фиксированной сетке со стандартным нормальным априорным, каждый ответ
+// добавляет к нему логарифм правдоподобия за O(kPoints). В отличие от оценки
+// максимального правдоподобия, не уходит в бесконечность после серии только
+// верных или только неверных ответов.
+class AbilityEstimate
+{
+public:
+    AbilityEstimate();
+
+    void update(const ItemParameters &item, bool correct);
+
+    double theta() const { return mean; }
+    double standardError() const { return deviation; }
+    int count() const { return answered; }
+
+private:
+    static constexpr int kPoints = 81;
+    static constexpr double kRange = 4.0;
+
+    static double point(int i) { return -kRange + 2.0 * kRange * i / (kPoints - 1); }
+
+    double logPosterior[kPoints];
+    double mean = 0.0;
+    double deviation = 1.0;
+    int answered = 0;
+};
+
+#endif // IRTMODEL_H
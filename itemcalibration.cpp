@@ -0,0 +1,183 @@
+#include "itemcalibration.h"
+#include "compiledquiz.h"
+#include "journalline.h"
+#include "quizdeltalog.h"
+#include "scorestore.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Разброс априорных: a ~ N(a0, 0.5²), b ~ N(b0, 1)
+const double kPriorVarianceA = 0.25;
+const double kPriorVarianceB = 1.0;
+
+const float kMinA = 0.2f;
+const float kMaxA = 4.0f;
+const float kMaxB = 4.0f;
+
+} // namespace
+
+QString ItemCalibration::parametersPath(const QString &quizFileName)
+{
+    return quizFileName + ".irt";
+}
+
+QByteArray ItemCalibration::contentHash(const QString &quizFileName)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString &path : {quizFileName, QuizDeltaLog::deltaPath(quizFileName)}) {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly))
+            hash.addData(&file);
+    }
+    return hash.result().toHex();
+}
+
+QVector<ItemParameters> ItemCalibration::priors(const CompiledQuiz &quiz)
+{
+    QVector<ItemParameters> items(quiz.count());
+    for (int i = 0; i < quiz.count(); ++i)
+        items[i] = Irt::prior(quiz.difficulty(i));
+    return items;
+}
+
+QVector<ItemParameters> ItemCalibration::load(const QString &quizFileName, const CompiledQuiz &quiz)
+{
+    QVector<ItemParameters> items = priors(quiz);
+    QFile file(parametersPath(quizFileName));
+    if (!file.open(QIODevice::ReadOnly))
+        return items;
+
+    // Файл от другой редакции банка: номера вопросов в нём могут указывать не туда
+    QJsonObject header;
+    if (!JournalLine::decode(file.readLine(), &header) || header["count"].toInt(-1) != quiz.count()
+        || header["hash"].toString().toLatin1() != contentHash(quizFileName))
+        return items;
+
+    while (!file.atEnd()) {
+        QJsonObject record;
+        if (!JournalLine::decode(file.readLine(), &record))
+            continue;
+        const int index = record["index"].toInt(-1);
+        if (index < 0 || index >= items.size())
+            continue;
+        // Файл правится и вручную: a ≤ 0 ломает оценку верхней границы информации
+        // в AdaptiveSelector, поэтому значения приводятся к тем же пределам, что и при калибровке
+        items[index].a = std::clamp(float(record["a"].toDouble(1.0)), kMinA, kMaxA);
+        items[index].b = std::clamp(float(record["b"].toDouble()), -kMaxB, kMaxB);
+        items[index].responses = record["responses"].toInt();
+    }
+    return items;
+}
+
+bool ItemCalibration::save(const QString &quizFileName, const QVector<ItemParameters> &items, QString *error)
+{
+    QJsonObject header;
+    header["count"] = items.size();
+    header["hash"] = QString::fromLatin1(contentHash(quizFileName));
+    QByteArray lines = JournalLine::encode(header);
+    for (int i = 0; i < items.size(); ++i) {
+        if (items[i].responses == 0)
+            continue;
+        QJsonObject record;
+        record["index"] = i;
+        record["a"] = items[i].a;
+        record["b"] = items[i].b;
+        record["responses"] = items[i].responses;
+        lines += JournalLine::encode(record);
+    }
+
+    QSaveFile file(parametersPath(quizFileName));
+    if (!file.open(QIODevice::WriteOnly) || file.write(lines) != lines.size() || !file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QVector<ItemCalibration::Response> ItemCalibration::responsesOf(const ScoreRecord &record)
+{
+    QVector<Response> responses;
+    responses.reserve(record.answers.size());
+    for (const ScoreRecord::Answer &answer : record.answers) {
+        Response response;
+        response.question = answer.question;
+        response.correct = answer.correct();
+        responses.append(response);
+    }
+    return responses;
+}
+
+QVector<ItemParameters> ItemCalibration::calibrate(const QVector<ItemParameters> &priors,
+                                                   const QVector<QVector<Response>> &sessions,
+                                                   int iterations)
+{
+    QVector<ItemParameters> items = priors;
+    const int n = items.size();
+
+    // Градиент и информация Фишера по (a, b) каждого вопроса
+    QVector<double> gradA(n), gradB(n), infoAA(n), infoBB(n), infoAB(n);
+    QVector<int> counts(n);
+
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        gradA.fill(0.0);
+        gradB.fill(0.0);
+        infoAA.fill(0.0);
+        infoBB.fill(0.0);
+        infoAB.fill(0.0);
+        counts.fill(0);
+
+        for (const QVector<Response> &session : sessions) {
+            AbilityEstimate ability;
+            for (const Response &response : session) {
+                if (response.question < n)
+                    ability.update(items[response.question], response.correct);
+            }
+            const double theta = ability.theta();
+
+            for (const Response &response : session) {
+                const int q = response.question;
+                if (q >= n)
+                    continue;
+                const double a = items[q].a;
+                const double p = Irt::probability(items[q], theta);
+                const double residual = (response.correct ? 1.0 : 0.0) - p;
+                const double distance = theta - items[q].b;
+                const double weight = p * (1.0 - p);
+                gradA[q] += residual * distance;
+                gradB[q] -= a * residual;
+                infoAA[q] += weight * distance * distance;
+                infoBB[q] += weight * a * a;
+                infoAB[q] -= weight * a * distance;
+                ++counts[q];
+            }
+        }
+
+        for (int q = 0; q < n; ++q) {
+            if (counts[q] == 0)
+                continue;
+            const double ga = gradA[q] - (items[q].a - priors[q].a) / kPriorVarianceA;
+            const double gb = gradB[q] - (items[q].b - priors[q].b) / kPriorVarianceB;
+            const double iaa = infoAA[q] + 1.0 / kPriorVarianceA;
+            const double ibb = infoBB[q] + 1.0 / kPriorVarianceB;
+            const double iab = infoAB[q];
+            const double det = iaa * ibb - iab * iab;
+            if (det <= 0)
+                continue;
+
+            // Шаг ограничен, чтобы первые итерации с грубыми θ не разбрасывали параметры
+            const double stepA = std::clamp((ibb * ga - iab * gb) / det, -0.5, 0.5);
+            const double stepB = std::clamp((iaa * gb - iab * ga) / det, -1.0, 1.0);
+            items[q].a = std::clamp(float(items[q].a + stepA), kMinA, kMaxA);
+            items[q].b = std::clamp(float(items[q].b + stepB), -kMaxB, kMaxB);
+            items[q].responses = counts[q];
+        }
+    }
+    return items;
+}
@@ -0,0 +1,47 @@
+#ifndef ITEMCALIBRATION_H
+#define ITEMCALIBRATION_H
+
+#include <QString>
+#include <QVector>
+
+#include "irtmodel.h"
+
+class CompiledQuiz;
+struct ScoreRecord;
+
+// Калибровка параметров 2PL по истории результатов и их хранение рядом с
+// викториной в "<файл>.irt" строками JournalLine. В файл попадают только
+// вопросы, на которые уже отвечали; остальные получают априорные значения
+// по полю сложности, поэтому новый банк сразу пригоден для адаптивного теста.
+// Первая строка файла — отпечаток викторины и число вопросов: параметры
+// привязаны к номерам вопросов, поэтому после правки банка файл не читается.
+class ItemCalibration
+{
+public:
+    struct Response
+    {
+        int question = 0;
+        bool correct = false;
+    };
+
+    static QString parametersPath(const QString &quizFileName);
+    // SHA-1 файла викторины и её журнала правок
+    static QByteArray contentHash(const QString &quizFileName);
+
+    static QVector<ItemParameters> priors(const CompiledQuiz &quiz);
+    // Априорные значения, поверх них — откалиброванные из файла
+    static QVector<ItemParameters> load(const QString &quizFileName, const CompiledQuiz &quiz);
+    static bool save(const QString &quizFileName, const QVector<ItemParameters> &items, QString *error = nullptr);
+
+    // Верность ответов записи по вопросам (поле answers)
+    static QVector<Response> responsesOf(const ScoreRecord &record);
+
+    // Совместная оценка максимума апостериорной вероятности: по очереди
+    // уточняются уровни участников (EAP) и параметры вопросов (шаг Фишера с
+    // нормальными априорными вокруг priors). O(итераций × число ответов).
+    static QVector<ItemParameters> calibrate(const QVector<ItemParameters> &priors,
+                                             const QVector<QVector<Response>> &sessions,
+                                             int iterations = 30);
+};
+
+#endif // ITEMCALIBRATION_H
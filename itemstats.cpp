@@ -0,0 +1,86 @@
+#include "itemstats.h"
+#include "scorestore.h"
+
+#include <cmath>
+#include <limits>
+
+double ItemStats::Item::percentCorrect() const
+{
+    return attempts > 0 ? 100.0 * correct / attempts : 0.0;
+}
+
+double ItemStats::Item::discrimination() const
+{
+    if (paired < 2)
+        return std::numeric_limits<double>::quiet_NaN();
+    const double n = paired;
+    const double meanX = pairedCorrect / n;
+    const double meanY = sumY / n;
+    const double varianceX = meanX * (1.0 - meanX);
+    const double varianceY = sumY2 / n - meanY * meanY;
+    if (varianceX <= 0 || varianceY <= 1e-12)
+        return std::numeric_limits<double>::quiet_NaN();
+    return (sumXY / n - meanX * meanY) / std::sqrt(varianceX * varianceY);
+}
+
+double ItemStats::Item::optionRate(int option) const
+{
+    return attempts > 0 ? 100.0 * chosen[option] / attempts : 0.0;
+}
+
+double ItemStats::Item::meanTimeMs() const
+{
+    return timed > 0 ? double(totalMs) / timed : 0.0;
+}
+
+void ItemStats::add(const ScoreRecord &record)
+{
+    int correctTotal = 0;
+    for (const ScoreRecord::Answer &answer : record.answers)
+        correctTotal += answer.correct() ? 1 : 0;
+
+    // Время идёт по позициям плана так же, как ответы
+    const bool timed = record.times.size() == record.answers.size();
+    const int others = record.answers.size() - 1;
+
+    for (int k = 0; k < record.answers.size(); ++k) {
+        const ScoreRecord::Answer &answer = record.answers[k];
+        if (answer.question < 0 || answer.question >= items.size())
+            continue;
+        Item &item = items[answer.question];
+        if (item.attempts > 0 && item.key != answer.key)
+            item = Item();
+
+        const bool correct = answer.correct();
+        ++item.attempts;
+        item.correct += correct ? 1 : 0;
+        item.key = answer.key;
+        if (answer.mask == 0)
+            ++item.blank;
+        for (int option = 0; option < 4; ++option) {
+            if (answer.mask & (1u << option))
+                ++item.chosen[option];
+        }
+        if (timed) {
+            item.totalMs += record.times[k];
+            ++item.timed;
+        }
+
+        if (others > 0) {
+            const double rest = double(correctTotal - (correct ? 1 : 0)) / others;
+            ++item.paired;
+            item.pairedCorrect += correct ? 1 : 0;
+            item.sumY += rest;
+            item.sumY2 += rest * rest;
+            item.sumXY += correct ? rest : 0.0;
+        }
+    }
+    ++recorded;
+}
+
+const ItemStats::Item *ItemStats::item(int question) const
+{
+    if (question < 0 || question >= items.size() || items[question].attempts == 0)
+        return nullptr;
+    return &items[question];
+}
@@ -0,0 +1,64 @@
+#ifndef ITEMSTATS_H
+#define ITEMSTATS_H
+
+#include <QtGlobal>
+#include <QVector>
+
+struct ScoreRecord;
+
+// Статистика вопросов викторины по истории ответов. Все показатели выводятся
+// из накопленных сумм, поэтому новая запись добавляется за O(число её ответов)
+// без пересчёта истории. Различающая способность — точечно-бисериальная
+// корреляция верности ответа с долей верных ответов участника на остальные
+// вопросы той же записи (в отличие от метода крайних групп, её можно
+// накапливать по одной записи).
+//
+// Суммы вопроса относятся к одному ключу (набору правильных вариантов): ответ,
+// записанный с другим ключом, значит, что вопрос исправили, и счёт по нему
+// начинается заново. Записи приходят в порядке журнала, поэтому остаётся
+// статистика по последнему ключу.
+//
+// Номера вопросов берутся из журнала, поэтому ответы вне [0, questionCount)
+// отбрасываются: испорченная запись не раздувает таблицу.
+class ItemStats
+{
+public:
+    struct Item
+    {
+        int attempts = 0;
+        int correct = 0;
+        int blank = 0;
+        int chosen[4] = {0, 0, 0, 0};
+        quint8 key = 0;             // правильные варианты, по которым накоплены суммы
+        qint64 totalMs = 0;
+        int timed = 0;
+
+        // Суммы для корреляции: x — верный ответ, y — доля верных на остальные вопросы
+        int paired = 0;
+        int pairedCorrect = 0;
+        double sumY = 0.0;
+        double sumY2 = 0.0;
+        double sumXY = 0.0;
+
+        double percentCorrect() const;
+        // NaN, пока не хватает данных или все ответили одинаково
+        double discrimination() const;
+        double optionRate(int option) const;
+        double meanTimeMs() const;
+    };
+
+    explicit ItemStats(int questionCount = 0) : items(questionCount) {}
+
+    int questionCount() const { return items.size(); }
+    void add(const ScoreRecord &record);
+
+    int records() const { return recorded; }
+    // nullptr, если на вопрос ещё не отвечали
+    const Item *item(int question) const;
+
+private:
+    QVector<Item> items;
+    int recorded = 0;
+};
+
+#endif // ITEMSTATS_H
@@ -0,0 +1,72 @@
+#include "journalline.h"
+
+#include <QJsonDocument>
+#include <array>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace JournalLine {
+
+quint32 crc32(const QByteArray &data)
+{
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (char ch : data)
+        crc = table[(crc ^ static_cast<quint8>(ch)) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+QByteArray encode(const QJsonObject &record)
+{
+    const QByteArray json = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    return QByteArray::number(crc32(json), 16).rightJustified(8, '0') + '\t' + json + '\n';
+}
+
+bool decode(const QByteArray &line, QJsonObject *record)
+{
+    const int tab = line.indexOf('\t');
+    if (tab != 8)
+        return false;
+
+    QByteArray json = line.mid(tab + 1);
+    while (json.endsWith('\n') || json.endsWith('\r'))
+        json.chop(1);
+
+    bool ok = false;
+    const quint32 stored = line.left(tab).toUInt(&ok, 16);
+    if (!ok || stored != crc32(json))
+        return false;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    if (!doc.isObject())
+        return false;
+    *record = doc.object();
+    return true;
+}
+
+bool syncFile(QFile &file)
+{
+    if (!file.flush())
+        return false;
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+} // namespace JournalLine
@@ -0,0 +1,21 @@
+#ifndef JOURNALLINE_H
+#define JOURNALLINE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QJsonObject>
+
+// Строка журнала: "<crc32 в hex>\t<компактный json>\n". Повреждённые и
+// оборванные строки не проходят проверку и пропускаются при чтении.
+namespace JournalLine {
+
+quint32 crc32(const QByteArray &data);
+QByteArray encode(const QJsonObject &record);
+bool decode(const QByteArray &line, QJsonObject *record);
+
+// flush + fsync: после возврата данные гарантированно на диске
+bool syncFile(QFile &file);
+
+} // namespace JournalLine
+
+#endif // JOURNALLINE_H
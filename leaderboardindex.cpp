@@ -0,0 +1,71 @@
+#include "leaderboardindex.h"
+
+#include <algorithm>
+
+void LeaderboardIndex::grow(int score)
+{
+    int size = std::max(16, static_cast<int>(buckets.size()));
+    while (size < score + 1)
+        size *= 2;
+    if (size == buckets.size())
+        return;
+
+    buckets.resize(size);
+    tree.fill(0, size + 1);
+    for (int i = 1; i <= size; ++i) {
+        tree[i] += buckets[i - 1].size();
+        const int parent = i + (i & -i);
+        if (parent <= size)
+            tree[parent] += tree[i];
+    }
+}
+
+void LeaderboardIndex::insert(int recordId, int score)
+{
+    score = std::max(score, 0);
+    if (score >= buckets.size())
+        grow(score);
+
+    buckets[score].append(recordId);
+    for (int i = score + 1; i < tree.size(); i += i & -i)
+        ++tree[i];
+    ++total;
+}
+
+int LeaderboardIndex::prefix(int score) const
+{
+    int sum = 0;
+    for (int i = std::min(score + 1, static_cast<int>(buckets.size())); i > 0; i -= i & -i)
+        sum += tree[i];
+    return sum;
+}
+
+int LeaderboardIndex::countAbove(int score) const
+{
+    return total - prefix(score);
+}
+
+int LeaderboardIndex::recordAt(int row) const
+{
+    if (row < 0 || row >= total)
+        return -1;
+
+    // Ищем корзину, в которую попадает (total - 1 - row)-я запись по возрастанию
+    const int size = buckets.size();
+    int remaining = total - 1 - row;
+    int pos = 0;
+    for (int step = size; step > 0; step >>= 1) {
+        if (pos + step <= size && tree[pos + step] <= remaining) {
+            pos += step;
+            remaining -= tree[pos];
+        }
+    }
+
+    const int score = pos;
+    return buckets[score][row - countAbove(score)];
+}
+
+int LeaderboardIndex::rankOf(int score) const
+{
+    return countAbove(std::max(score, 0)) + 1;
+}
@@ -0,0 +1,28 @@
+#ifndef LEADERBOARDINDEX_H
+#define LEADERBOARDINDEX_H
+
+#include <QVector>
+
+// Индекс рейтинга одной викторины: записи разложены по корзинам баллов,
+// а дерево Фенвика над размерами корзин даёт место и строку по номеру
+// за O(log S), где S — максимальный балл. Вставка — амортизированно O(log S).
+class LeaderboardIndex
+{
+public:
+    void insert(int recordId, int score);
+
+    int count() const { return total; }
+    int recordAt(int row) const;
+    int rankOf(int score) const;
+
+private:
+    void grow(int score);
+    int prefix(int score) const;
+    int countAbove(int score) const;
+
+    QVector<int> tree;
+    QVector<QVector<int>> buckets;
+    int total = 0;
+};
+
+#endif // LEADERBOARDINDEX_H
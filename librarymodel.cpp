@@ -0,0 +1,101 @@
+#include "librarymodel.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QLocale>
+#include <algorithm>
+
+LibraryModel::LibraryModel(const QuizCatalog *catalog, QObject *parent)
+    : QAbstractTableModel(parent), catalog(catalog)
+{
+}
+
+void LibraryModel::setDirectory(const QString &path)
+{
+    beginResetModel();
+    dirPath = QDir(path).absolutePath();
+    paths.clear();
+    for (const QuizCatalog::Entry &entry : catalog->entriesUnder(dirPath))
+        paths << entry.path;
+    std::sort(paths.begin(), paths.end());
+    endResetModel();
+}
+
+void LibraryModel::entryChanged(const QString &path)
+{
+    if (!path.startsWith(dirPath + '/'))
+        return;
+
+    const auto it = std::lower_bound(paths.begin(), paths.end(), path);
+    const int row = int(it - paths.begin());
+    if (it != paths.end() && *it == path) {
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+        return;
+    }
+    beginInsertRows(QModelIndex(), row, row);
+    paths.insert(row, path);
+    endInsertRows();
+}
+
+void LibraryModel::entryRemoved(const QString &path)
+{
+    const auto it = std::lower_bound(paths.begin(), paths.end(), path);
+    if (it == paths.end() || *it != path)
+        return;
+    const int row = int(it - paths.begin());
+    beginRemoveRows(QModelIndex(), row, row);
+    paths.removeAt(row);
+    endRemoveRows();
+}
+
+int LibraryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : paths.size();
+}
+
+int LibraryModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant LibraryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+    const QuizCatalog::Entry *entry = catalog->find(paths[index.row()]);
+    if (!entry)
+        return QVariant();
+
+    if (role == Qt::ToolTipRole)
+        return entry->error.isEmpty() ? entry->path : entry->error;
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (index.column()) {
+    case FileColumn:
+        return entry->path.mid(dirPath.size() + 1);
+    case QuestionsColumn:
+        return entry->error.isEmpty() ? QVariant(entry->questions) : QVariant("ошибка");
+    case DifficultyColumn:
+        return QString("%1 / %2 / %3").arg(entry->byDifficulty[1]).arg(entry->byDifficulty[2]).arg(entry->byDifficulty[3]);
+    case TimeColumn:
+        return QString("%1:%2").arg(entry->seconds / 60).arg(entry->seconds % 60, 2, 10, QChar('0'));
+    case ModifiedColumn:
+        return QLocale().toString(QDateTime::fromMSecsSinceEpoch(entry->modified), QLocale::ShortFormat);
+    }
+    return QVariant();
+}
+
+QVariant LibraryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    switch (section) {
+    case FileColumn: return "Файл";
+    case QuestionsColumn: return "Вопросов";
+    case DifficultyColumn: return "Лёгкие / средние / сложные";
+    case TimeColumn: return "Время";
+    case ModifiedColumn: return "Изменён";
+    }
+    return QVariant();
+}
@@ -0,0 +1,40 @@
+#ifndef LIBRARYMODEL_H
+#define LIBRARYMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+
+#include "quizcatalog.h"
+
+// Таблица библиотеки: строки — файлы папки из каталога, данные строки
+// берутся из каталога по пути. Сканер сообщает об изменённых и удалённых
+// файлах, и модель обновляет только соответствующие строки.
+class LibraryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { FileColumn, QuestionsColumn, DifficultyColumn, TimeColumn, ModifiedColumn, ColumnCount };
+
+    LibraryModel(const QuizCatalog *catalog, QObject *parent = nullptr);
+
+    void setDirectory(const QString &dirPath);
+    QString pathAt(int row) const { return paths.value(row); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+public slots:
+    void entryChanged(const QString &path);
+    void entryRemoved(const QString &path);
+
+private:
+    const QuizCatalog *catalog;
+    QString dirPath;
+    // Пути по возрастанию, поиск строки — двоичный
+    QStringList paths;
+};
+
+#endif // LIBRARYMODEL_H
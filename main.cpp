@@ -1,9 +1,160 @@
 #include "mainwindow.h"
+#include "quizsource.h"
+#include "startupprofiler.h"
+#include "theme.h"
+#include "quizeditor.h"
+#include "quiztaker.h"
 #include <QApplication>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// Текущий RSS процесса в КБ (только Linux, иначе 0)
+qint64 residentKb()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly))
+        return 0;
+    while (!status.atEnd()) {
+        const QByteArray line = status.readLine();
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return 0;
+}
+
+// QuizApp --convert <вход> <выход>: JSON <-> *.quizbin, направление по расширению выхода
+int convertQuiz(const QStringList &args)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (args.size() != 4) {
+        err << "Использование: QuizApp --convert <вход.json|вход.quizbin> <выход.quizbin|выход.json>\n";
+        return 2;
+    }
+
+    const QString input = args[2];
+    const QString output = args[3];
+
+    QuizSource source;
+    if (!source.open(input)) {
+        err << "Ошибка чтения " << input << ": " << source.errorString() << "\n";
+        return 1;
+    }
+
+    QString error;
+    if (!QuizSource::save(source.questions(), output, &error)) {
+        err << "Ошибка записи " << output << ": " << error << "\n";
+        return 1;
+    }
+    out << "Записано вопросов: " << source.count() << " -> " << output << "\n";
+
+    // Сравнение загрузки: первый вопрос скомпилированного файла против полного разбора JSON
+    const QString compiledPath = QuizBinary::isCompiledFile(output) ? output : input;
+    const QString jsonPath = compiledPath == output ? input : output;
+
+    QElapsedTimer timer;
+    qint64 rssBefore = residentKb();
+    timer.start();
+    QuizSource compiled;
+    compiled.open(compiledPath);
+    compiled.question(0);
+    out << "quizbin: открытие и первый вопрос " << timer.nsecsElapsed() / 1000 << " мкс, RSS +"
+        << residentKb() - rssBefore << " КБ\n";
+
+    rssBefore = residentKb();
+    timer.restart();
+    QuizSource json;
+    json.open(jsonPath);
+    json.question(0);
+    out << "json:    открытие и первый вопрос " << timer.nsecsElapsed() / 1000 << " мкс, RSS +"
+        << residentKb() - rssBefore << " КБ\n";
+    return 0;
+}
+
+// QuizApp --profile-ui <викторина>: время создания и перерисовки окон редактора
+// и прохождения с темой приложения
+int profileWindows(QApplication &app, const QString &fileName)
+{
+    QTextStream out(stdout);
+    const int kRounds = 5;
+    const int kRepaints = 50;
+
+    // Медианы по kRounds окнам: первое создание прогревает кэши шрифтов и стилей
+    auto measure = [&](const std::function<QWidget *()> &create, const char *name) {
+        QVector<qint64> created;
+        QVector<qint64> repainted;
+        for (int round = 0; round < kRounds; ++round) {
+            QElapsedTimer timer;
+            timer.start();
+            QWidget *window = create();
+            window->ensurePolished();
+            created.append(timer.nsecsElapsed());
+
+            window->show();
+            app.processEvents();
+            timer.restart();
+            for (int i = 0; i < kRepaints; ++i)
+                window->repaint();
+            repainted.append(timer.nsecsElapsed() / kRepaints);
+            delete window;
+            app.processEvents();
+        }
+        std::sort(created.begin(), created.end());
+        std::sort(repainted.begin(), repainted.end());
+        out << QString("%1 %2 %3\n").arg(name, -11).arg(created[kRounds / 2] / 1000, 14)
+                   .arg(repainted[kRounds / 2] / 1000, 17);
+    };
+
+    out << "окно        создание, мкс  перерисовка, мкс\n";
+    measure([]() -> QWidget * { return new QuizEditor; }, "QuizEditor");
+    measure([&fileName]() -> QWidget * { return new QuizTaker(fileName); }, "QuizTaker");
+    return 0;
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
+    StartupProfiler *profiler = StartupProfiler::instance();
+    profiler->mark("main");
+
+    if (argc >= 2 && qstrcmp(argv[1], "--convert") == 0) {
+        QCoreApplication app(argc, argv);
+        return convertQuiz(app.arguments());
+    }
+
+    // QuizApp --profile-startup: вывести время фаз запуска до первого кадра и выйти
+    const bool profileStartup = argc >= 2 && qstrcmp(argv[1], "--profile-startup") == 0;
+
     QApplication a(argc, argv);
+    profiler->mark("QApplication");
+    Theme::apply(a);
+    profiler->mark("тема");
+
+    if (argc >= 3 && qstrcmp(argv[1], "--profile-ui") == 0)
+        return profileWindows(a, a.arguments().at(2));
+
     MainWindow w;
+    profiler->mark("MainWindow");
     w.show();
+    profiler->mark("show");
+
+    if (profileStartup) {
+        profiler->watchFirstFrame(&w);
+        QObject::connect(profiler, &StartupProfiler::firstFrame, &a, [&a, profiler]() {
+            // Отложенная картинка загружается в следующем проходе цикла событий
+            QTimer::singleShot(0, &a, [&a, profiler]() {
+                profiler->report();
+                a.quit();
+            });
+        });
+    }
     return a.exec();
 }
@@ -3,19 +3,56 @@
 #include "quizeditor.h"
 #include "quizviewer.h"
 #include "quiztaker.h"
+#include "quizlibrary.h"
+#include "sessionclient.h"
+#include "startupprofiler.h"
 
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPixmap>
+#include <QImage>
+#include <QResource>
+#include <QTimer>
+#include <QtEndian>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QStringList>
 
+namespace {
+
+// Картинка, заранее масштабированная при сборке (см. assetbaker.cpp). Пиксели
+// берутся прямо из ресурса без декодирования; пустой QImage — ресурса нет.
+QImage bakedImage(const QString &path)
+{
+    QResource resource(path);
+    if (!resource.isValid() || resource.compressionAlgorithm() != QResource::NoCompression
+        || resource.size() < 20)
+        return QImage();
+
+    const uchar *data = resource.data();
+    if (QByteArray::fromRawData(reinterpret_cast<const char *>(data), 4) != "MSIM")
+        return QImage();
+
+    const int width = qFromLittleEndian<quint32>(data + 4);
+    const int height = qFromLittleEndian<quint32>(data + 8);
+    const int bytesPerLine = qFromLittleEndian<quint32>(data + 12);
+    const auto format = static_cast<QImage::Format>(qFromLittleEndian<quint32>(data + 16));
+    if (resource.size() < 20 + qint64(bytesPerLine) * height)
+        return QImage();
+
+    const QImage image(data + 20, width, height, bytesPerLine, format);
+    // Пиксели ARGB32 читаются словами, поэтому невыровненные данные копируются
+    return quintptr(data + 20) % 4 == 0 ? image : image.copy();
+}
+
+} // namespace
+
 void MainWindow::onCreateQuiz() {
     auto *editor = new QuizEditor(nullptr);
     editor->setAttribute(Qt::WA_DeleteOnClose);
@@ -26,10 +63,27 @@ void MainWindow::onCreateQuiz() {
 
 void MainWindow::onOpenQuiz()
 {
-    QString fileName = QFileDialog::getOpenFileName(this, "Открыть викторину", "", "Файлы викторин (*.json)");
+    QString fileName = QFileDialog::getOpenFileName(this, "Открыть викторину", "", "Файлы викторин (*.json *.quizbin)");
     if (fileName.isEmpty())
         return;
+    openQuizFile(fileName);
+}
+
+void MainWindow::onOpenLibrary()
+{
+    // Окно одно на всё приложение: каталог и наблюдение за папкой живут с ним
+    if (!library) {
+        library = new QuizLibrary(this);
+        library->resize(800, 500);
+        connect(library, &QuizLibrary::quizChosen, this, &MainWindow::openQuizFile);
+    }
+    library->show();
+    library->raise();
+    library->activateWindow();
+}
 
+void MainWindow::openQuizFile(const QString &fileName)
+{
     QMessageBox msgBox;
     msgBox.setWindowTitle("Выберите действие");
     msgBox.setText("Что вы хотите сделать с викториной?");
@@ -53,6 +107,39 @@ void MainWindow::onOpenQuiz()
     }
 }
 
+void MainWindow::onJoinSession()
+{
+    bool ok;
+    const QString address = QInputDialog::getText(this, "Сессия класса", "Адрес сервера (хост:порт):",
+                                                  QLineEdit::Normal, "127.0.0.1:5050", &ok).trimmed();
+    if (!ok || address.isEmpty())
+        return;
+    const QString name = QInputDialog::getText(this, "Сессия класса", "Ваше имя:",
+                                               QLineEdit::Normal, "", &ok).trimmed();
+    if (!ok || name.isEmpty())
+        return;
+
+    QString host = address;
+    quint16 port = 5050;
+    const int colon = address.lastIndexOf(':');
+    if (colon > 0) {
+        host = address.left(colon);
+        port = quint16(address.mid(colon + 1).toUInt(&ok));
+        if (!ok || port == 0) {
+            QMessageBox::warning(this, "Ошибка", "Неверный порт: " + address.mid(colon + 1));
+            return;
+        }
+    }
+
+    auto *client = new SessionClient;
+    auto *taker = new QuizTaker(client);
+    taker->setAttribute(Qt::WA_DeleteOnClose);
+    taker->setWindowTitle("Сессия класса");
+    taker->resize(800, 600);
+    taker->show();
+    client->connectToServer(host, port, name);
+}
+
 void MainWindow::onAbout() {
     QMessageBox::about(this, "О программе", "Милое приложение для викторин\nКурсовая работа Ерофеевой Дарьи Денисовны и Новиковой Дарьи Дмитриевны 🐾");
 }
@@ -60,12 +147,13 @@ void MainWindow::onAbout() {
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow) {
     ui->setupUi(this);
-
-    this->setStyleSheet("QMainWindow { background-color: #FFC0CB; }");
+    StartupProfiler::instance()->mark("setupUi");
 
     QMenu *fileMenu = menuBar()->addMenu("Файл");
     QAction *createQuizAction = fileMenu->addAction("Создать викторину");
     QAction *openQuizAction = fileMenu->addAction("Открыть викторину");
+    QAction *libraryAction = fileMenu->addAction("Библиотека викторин");
+    QAction *joinSessionAction = fileMenu->addAction("Подключиться к сессии…");
     QAction *exitAction = fileMenu->addAction("Выход");
 
     QMenu *helpMenu = menuBar()->addMenu("Помощь");
@@ -73,29 +161,35 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(createQuizAction, &QAction::triggered, this, &MainWindow::onCreateQuiz);
     connect(openQuizAction, &QAction::triggered, this, &MainWindow::onOpenQuiz);
+    connect(libraryAction, &QAction::triggered, this, &MainWindow::onOpenLibrary);
+    connect(joinSessionAction, &QAction::triggered, this, &MainWindow::onJoinSession);
     connect(exitAction, &QAction::triggered, this, &QMainWindow::close);
     connect(aboutAction, &QAction::triggered, this, &MainWindow::onAbout);
 
-    QLabel *label = new QLabel(this);
-    QPixmap pixmap(":/capibara.jpg");
-    label->setPixmap(pixmap.scaled(400, 300, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    label->setAlignment(Qt::AlignCenter);
+    // Картинка загружается после первого кадра (см. event), место под неё резервируется сразу
+    pictureLabel = new QLabel(this);
+    pictureLabel->setMinimumSize(400, 300);
+    pictureLabel->setAlignment(Qt::AlignCenter);
 
     QPushButton *btnCreate = new QPushButton("Создать викторину");
     QPushButton *btnOpen = new QPushButton("Открыть викторину");
+    QPushButton *btnLibrary = new QPushButton("Библиотека викторин");
 
-    btnCreate->setStyleSheet("QPushButton { background-color: #FF69B4; border: 2px solid white; color: white; padding: 10px; border-radius: 10px; }");
-    btnOpen->setStyleSheet("QPushButton { background-color: #FF69B4; border: 2px solid white; color: white; padding: 10px; border-radius: 10px; }");
+    btnCreate->setObjectName("mainButton");
+    btnOpen->setObjectName("mainButton");
+    btnLibrary->setObjectName("mainButton");
 
     connect(btnCreate, &QPushButton::clicked, this, &MainWindow::onCreateQuiz);
     connect(btnOpen, &QPushButton::clicked, this, &MainWindow::onOpenQuiz);
+    connect(btnLibrary, &QPushButton::clicked, this, &MainWindow::onOpenLibrary);
 
     QWidget *central = new QWidget(this);
     QVBoxLayout *layout = new QVBoxLayout(central);
-    layout->addWidget(label);
+    layout->addWidget(pictureLabel);
     layout->addSpacing(20);
     layout->addWidget(btnCreate);
     layout->addWidget(btnOpen);
+    layout->addWidget(btnLibrary);
     layout->setAlignment(Qt::AlignTop | Qt::AlignHCenter);
 
     setCentralWidget(central);
@@ -103,6 +197,30 @@ MainWindow::MainWindow(QWidget *parent)
     resize(600, 500);
 }
 
+bool MainWindow::event(QEvent *event)
+{
+    // Таймер, заведённый в конструкторе, срабатывает раньше первого показа
+    // окна. Загрузка ставится в очередь из первой перерисовки и выполняется,
+    // когда кадр уже нарисован и выведен на экран
+    if (event->type() == QEvent::Paint && !pictureRequested) {
+        pictureRequested = true;
+        QTimer::singleShot(0, this, &MainWindow::loadPicture);
+    }
+    return QMainWindow::event(event);
+}
+
+void MainWindow::loadPicture()
+{
+    const QImage baked = bakedImage(":/capibara.argb");
+    if (!baked.isNull()) {
+        pictureLabel->setPixmap(QPixmap::fromImage(baked));
+    } else {
+        QPixmap pixmap(":/capibara.jpg");
+        pictureLabel->setPixmap(pixmap.scaled(400, 300, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    }
+    StartupProfiler::instance()->mark("картинка главного окна");
+}
+
 MainWindow::~MainWindow() {
     delete ui;
 }
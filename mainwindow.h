@@ -2,14 +2,14 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include "quizeditor.h"
-#include "quiztaker.h"
-#include <QMessageBox>
+#include <QLabel>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
+class QuizLibrary;
+
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
@@ -17,13 +17,24 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    bool event(QEvent *event) override;
+
 private slots:
     void onCreateQuiz();
     void onOpenQuiz();
+    void onOpenLibrary();
+    void openQuizFile(const QString &fileName);
+    void onJoinSession();
     void onAbout();
 
 private:
+    void loadPicture();
+
     Ui::MainWindow *ui;
+    QLabel *pictureLabel;
+    bool pictureRequested = false;
+    QuizLibrary *library = nullptr;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,94 @@
+#include "persistentquestions.h"
+
+const Question &PersistentQuestions::at(int index) const
+{
+    const Node *node = root.get();
+    for (int level = shift; level > 0; level -= kBits)
+        node = node->children[(index >> level) & kMask].get();
+    return node->items[index & kMask];
+}
+
+PersistentQuestions::NodePtr PersistentQuestions::setIn(const NodePtr &node, int level, int index,
+                                                        const Question &question)
+{
+    auto copy = std::make_shared<Node>(*node);
+    if (level == 0) {
+        copy->items[index & kMask] = question;
+    } else {
+        NodePtr &child = copy->children[(index >> level) & kMask];
+        child = setIn(child, level - kBits, index, question);
+    }
+    return copy;
+}
+
+PersistentQuestions PersistentQuestions::set(int index, const Question &question) const
+{
+    PersistentQuestions changed = *this;
+    if (index >= 0 && index < count)
+        changed.root = setIn(root, shift, index, question);
+    return changed;
+}
+
+void PersistentQuestions::appendIn(NodePtr &slot, int level, int index, const Question &question)
+{
+    // Узел другой версии не трогаем, а копируем; свой меняем на месте
+    if (!slot) {
+        slot = std::make_shared<Node>();
+        if (level == 0)
+            slot->items.reserve(kWidth);
+    } else if (slot.use_count() > 1) {
+        slot = std::make_shared<Node>(*slot);
+    }
+
+    if (level == 0) {
+        slot->items.push_back(question);
+        return;
+    }
+    const size_t child = (index >> level) & kMask;
+    if (child == slot->children.size())
+        slot->children.emplace_back();
+    appendIn(slot->children[child], level - kBits, index, question);
+}
+
+void PersistentQuestions::append(const Question &question)
+{
+    // Дерево заполнено — добавляем уровень сверху
+    if (root && count == (1 << (shift + kBits))) {
+        auto top = std::make_shared<Node>();
+        top->children.push_back(root);
+        root = top;
+        shift += kBits;
+    }
+    appendIn(root, shift, count, question);
+    ++count;
+}
+
+void PersistentQuestions::append(const QVector<Question> &batch)
+{
+    for (const Question &question : batch)
+        append(question);
+}
+
+void PersistentQuestions::clear()
+{
+    root.reset();
+    count = 0;
+    shift = 0;
+}
+
+void PersistentQuestions::collect(const Node &node, QVector<Question> &out)
+{
+    for (const Question &question : node.items)
+        out.append(question);
+    for (const NodePtr &child : node.children)
+        collect(*child, out);
+}
+
+QVector<Question> PersistentQuestions::toVector() const
+{
+    QVector<Question> all;
+    all.reserve(count);
+    if (root)
+        collect(*root, all);
+    return all;
+}
@@ -0,0 +1,53 @@
+#ifndef PERSISTENTQUESTIONS_H
+#define PERSISTENTQUESTIONS_H
+
+#include <QVector>
+#include <memory>
+#include <vector>
+
+#include "question.h"
+
+// Неизменяемый вектор вопросов с общей структурой: дерево с ветвлением 32,
+// вопросы лежат в листьях по 32 штуки. Копия — это копия указателя на
+// корень, а замена вопроса копирует только путь от корня к листу
+// (log32 n узлов), остальные узлы остаются общими со старой версией.
+// Поэтому каждая версия банка для истории правок стоит единицы килобайт.
+// Узел, который не разделён с другой версией, при добавлении меняется на
+// месте, так что загрузка банка по одному вопросу идёт за O(1) на вопрос.
+class PersistentQuestions
+{
+public:
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    const Question &at(int index) const;
+
+    PersistentQuestions set(int index, const Question &question) const;
+    void append(const Question &question);
+    void append(const QVector<Question> &batch);
+    void clear();
+
+    QVector<Question> toVector() const;
+    bool sharesRoot(const PersistentQuestions &other) const { return root == other.root; }
+
+private:
+    static const int kBits = 5;
+    static const int kWidth = 1 << kBits;
+    static const int kMask = kWidth - 1;
+
+    struct Node
+    {
+        std::vector<std::shared_ptr<Node>> children;
+        std::vector<Question> items;
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    static NodePtr setIn(const NodePtr &node, int shift, int index, const Question &question);
+    static void appendIn(NodePtr &slot, int shift, int index, const Question &question);
+    static void collect(const Node &node, QVector<Question> &out);
+
+    NodePtr root;
+    int count = 0;
+    int shift = 0;
+};
+
+#endif // PERSISTENTQUESTIONS_H
@@ -0,0 +1,70 @@
+#include "question.h"
+
+#include <QJsonArray>
+
+QVector<int> Question::correctIndexes() const
+{
+    QVector<int> indexes;
+    for (int i = 0; i < kOptionCount; ++i) {
+        if (isCorrect(i))
+            indexes.append(i);
+    }
+    return indexes;
+}
+
+bool Question::isComplete() const
+{
+    if (text.isEmpty() || correctMask == 0)
+        return false;
+    for (const QString &option : options) {
+        if (option.isEmpty())
+            return false;
+    }
+    return true;
+}
+
+QJsonObject Question::toJson() const
+{
+    QJsonObject obj;
+    obj["difficulty"] = difficulty;
+    obj["question"] = text;
+
+    QJsonArray correct;
+    for (int idx : correctIndexes())
+        correct.append(idx);
+    obj["correct"] = correct;
+
+    QJsonArray optionsArray;
+    for (const QString &option : options)
+        optionsArray.append(option);
+    obj["options"] = optionsArray;
+    return obj;
+}
+
+Question Question::fromJson(const QJsonObject &obj)
+{
+    Question q;
+    q.text = obj["question"].toString();
+    q.difficulty = static_cast<quint8>(obj["difficulty"].toInt(1));
+
+    const QJsonArray optionsArray = obj["options"].toArray();
+    for (int i = 0; i < kOptionCount && i < optionsArray.size(); ++i)
+        q.options[i] = optionsArray[i].toString();
+
+    for (const QJsonValue &val : obj["correct"].toArray()) {
+        const int idx = val.toInt(-1);
+        if (idx >= 0 && idx < kOptionCount)
+            q.correctMask |= 1u << idx;
+    }
+    return q;
+}
+
+QString Question::difficultyName(int difficulty)
+{
+    switch (difficulty) {
+    case 1: return "Лёгкий";
+    case 2: return "Средний";
+    case 3: return "Сложный";
+    default: return "Неизвестно";
+    }
+}
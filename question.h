@@ -0,0 +1,31 @@
+#ifndef QUESTION_H
+#define QUESTION_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include <QMetaType>
+
+// Один вопрос викторины в памяти. В JSON-файле он хранится так же,
+// как его пишет редактор: question, options[4], correct[], difficulty.
+struct Question
+{
+    static constexpr int kOptionCount = 4;
+
+    QString text;
+    QString options[kOptionCount];
+    quint8 correctMask = 0;
+    quint8 difficulty = 1;
+
+    bool isCorrect(int option) const { return correctMask & (1u << option); }
+    bool isComplete() const;
+    QVector<int> correctIndexes() const;
+
+    QJsonObject toJson() const;
+    static Question fromJson(const QJsonObject &obj);
+    static QString difficultyName(int difficulty);
+};
+
+Q_DECLARE_METATYPE(Question)
+
+#endif // QUESTION_H
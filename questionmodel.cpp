@@ -0,0 +1,117 @@
+#include "questionmodel.h"
+
+#include <QStringList>
+#include <algorithm>
+
+QuestionModel::QuestionModel(DisplayMode mode, QObject *parent)
+    : QAbstractListModel(parent), mode(mode)
+{
+}
+
+int QuestionModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return filtered ? visibleRows.size() : store.size();
+}
+
+QVariant QuestionModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const Question &q = store.at(sourceRow(index.row()));
+    if (mode == TitleOnly)
+        return q.text;
+
+    QStringList correctOptions;
+    for (int idx : q.correctIndexes())
+        correctOptions << q.options[idx];
+
+    return QString("Вопрос: %1\nПравильные ответы: %2\nСложность: %3")
+        .arg(q.text)
+        .arg(correctOptions.join(", "))
+        .arg(Question::difficultyName(q.difficulty));
+}
+
+void QuestionModel::append(const Question &question)
+{
+    append(QVector<Question>{question});
+}
+
+void QuestionModel::append(const QVector<Question> &batch)
+{
+    if (batch.isEmpty())
+        return;
+
+    // Под фильтром новые вопросы не видны, пока фильтр не сменится
+    if (filtered) {
+        store.append(batch);
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), store.size(), store.size() + batch.size() - 1);
+    store.append(batch);
+    endInsertRows();
+}
+
+void QuestionModel::setQuestion(int row, const Question &question)
+{
+    if (row < 0 || row >= store.size())
+        return;
+
+    store = store.set(row, question);
+    rowChanged(row);
+}
+
+void QuestionModel::restore(const PersistentQuestions &version, int row)
+{
+    if (version.size() != store.size())
+        return;
+    store = version;
+    rowChanged(row);
+}
+
+void QuestionModel::rowChanged(int row)
+{
+    const int shown = viewRow(row);
+    if (shown < 0)
+        return;
+    const QModelIndex changed = index(shown);
+    emit dataChanged(changed, changed);
+}
+
+void QuestionModel::clear()
+{
+    beginResetModel();
+    store.clear();
+    filtered = false;
+    visibleRows.clear();
+    endResetModel();
+}
+
+void QuestionModel::setRowFilter(const QVector<int> &rows)
+{
+    beginResetModel();
+    filtered = true;
+    visibleRows = rows;
+    endResetModel();
+}
+
+void QuestionModel::clearRowFilter()
+{
+    if (!filtered)
+        return;
+    beginResetModel();
+    filtered = false;
+    visibleRows.clear();
+    endResetModel();
+}
+
+int QuestionModel::viewRow(int sourceRow) const
+{
+    if (!filtered)
+        return sourceRow;
+    auto it = std::lower_bound(visibleRows.begin(), visibleRows.end(), sourceRow);
+    return it != visibleRows.end() && *it == sourceRow ? int(it - visibleRows.begin()) : -1;
+}
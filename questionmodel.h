@@ -0,0 +1,54 @@
+#ifndef QUESTIONMODEL_H
+#define QUESTIONMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+#include "question.h"
+#include "persistentquestions.h"
+
+// Единственное хранилище вопросов открытой викторины для редактора и
+// просмотрщика. Текст строки списка формируется только для видимых строк.
+// Вопросы лежат в PersistentQuestions, поэтому снимок банка для истории
+// правок или фоновой записи стоит O(1).
+class QuestionModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum DisplayMode { TitleOnly, Detailed };
+
+    explicit QuestionModel(DisplayMode mode = TitleOnly, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    int count() const { return store.size(); }
+    const Question &question(int row) const { return store.at(row); }
+    const PersistentQuestions &questions() const { return store; }
+
+    void append(const Question &question);
+    void append(const QVector<Question> &batch);
+    void setQuestion(int row, const Question &question);
+    // Вернуть версию банка, отличающуюся от текущей только вопросом row
+    void restore(const PersistentQuestions &version, int row);
+    void clear();
+
+    // Показывать только вопросы с данными номерами (по возрастанию).
+    // Номера строк представления переводятся в номера вопросов через sourceRow.
+    void setRowFilter(const QVector<int> &rows);
+    void clearRowFilter();
+    bool isFiltered() const { return filtered; }
+    int sourceRow(int viewRow) const { return filtered ? visibleRows[viewRow] : viewRow; }
+
+private:
+    int viewRow(int sourceRow) const;
+    void rowChanged(int row);
+
+    PersistentQuestions store;
+    DisplayMode mode;
+    bool filtered = false;
+    QVector<int> visibleRows;
+};
+
+#endif // QUESTIONMODEL_H
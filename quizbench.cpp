@@ -0,0 +1,587 @@
+#include "question.h"
+#include "quizsource.h"
+#include "quizbinary.h"
+#include "quizloader.h"
+#include "compiledquiz.h"
+#include "sessionplan.h"
+#include "gradingengine.h"
+#include "journalline.h"
+#include "scorejournal.h"
+#include "scorestore.h"
+#include "leaderboardindex.h"
+#include "quizgenerator.h"
+#include "duplicateindex.h"
+#include "searchindex.h"
+#include "adaptiveselector.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include <random>
+
+// QuizBench — замеры путей загрузки, сохранения, проверки ответов и таблицы
+// рекордов на банках и журналах заданного размера. Результаты выводятся в
+// JSON; с --baseline сравниваются с сохранённым прогоном, и при замедлении
+// больше порога программа завершается с кодом 1.
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+struct Result
+{
+    QString name;
+    int size = 0;
+    qint64 nsecs = 0;
+    int iterations = 0;
+};
+
+// Медиана нескольких повторов; повторы продолжаются, пока не наберётся minMs
+Result measure(const QString &name, int size, int minMs, const std::function<void()> &body)
+{
+    QVector<qint64> samples;
+    QElapsedTimer total;
+    total.start();
+    do {
+        QElapsedTimer timer;
+        timer.start();
+        body();
+        samples.append(timer.nsecsElapsed());
+    } while (samples.size() < 3 || (total.elapsed() < minMs && samples.size() < 1000));
+
+    std::sort(samples.begin(), samples.end());
+    Result result;
+    result.name = name;
+    result.size = size;
+    result.nsecs = samples[samples.size() / 2];
+    result.iterations = samples.size();
+    err() << name << " [" << size << "]: " << result.nsecs / 1000 << " мкс\n";
+    err().flush();
+    return result;
+}
+
+QVector<Question> makeQuestions(int count)
+{
+    QuizGenerator::Options options;
+    options.seed = quint64(count);
+    QuizGenerator generator(options);
+
+    QVector<Question> questions;
+    questions.reserve(count);
+    for (int i = 0; i < count; ++i)
+        questions.append(generator.nextQuestion());
+    return questions;
+}
+
+int loadStreaming(const QString &fileName)
+{
+    QEventLoop loop;
+    QuizLoader loader(fileName);
+    int loaded = 0;
+    QObject::connect(&loader, &QuizLoader::finished, &loop, [&](int count, bool) {
+        loaded = count;
+        loop.quit();
+    });
+    loader.start();
+    loop.exec();
+    return loaded;
+}
+
+void benchQuiz(int size, int minMs, const QString &dir, QVector<Result> &results)
+{
+    const QVector<Question> questions = makeQuestions(size);
+    const QString jsonPath = dir + QString("/bench-%1.json").arg(size);
+    const QString binPath = dir + QString("/bench-%1.quizbin").arg(size);
+
+    // QuizEditor::saveQuiz
+    results << measure("save.json", size, minMs, [&]() { QuizSource::save(questions, jsonPath); });
+    results << measure("save.quizbin", size, minMs, [&]() { QuizSource::save(questions, binPath); });
+
+    // QuizViewer::loadQuizFile и открытие в QuizTaker
+    results << measure("load.json.stream", size, minMs, [&]() { loadStreaming(jsonPath); });
+    results << measure("load.json", size, minMs, [&]() {
+        QuizSource source;
+        source.open(jsonPath);
+    });
+    results << measure("load.quizbin", size, minMs, [&]() {
+        QuizSource source;
+        source.open(binPath);
+        source.question(0);
+    });
+
+    QuizSource source;
+    source.open(binPath);
+    results << measure("compile.session", size, minMs, [&]() {
+        CompiledQuiz compiled;
+        compiled.append(source, 0, source.count());
+    });
+    // QuizTaker с *.quizbin: сложности всего банка и текст только вопросов плана
+    results << measure("compile.lazy", size, minMs, [&]() {
+        CompiledQuiz compiled;
+        compiled.appendLazy(source, 0, source.count());
+        for (int i = 0; i < qMin(20, compiled.count()); ++i)
+            compiled.compile(source, i * (compiled.count() / 20));
+    });
+
+    // QuizTaker::submitAnswer: ответы по плану сессии, по одному
+    CompiledQuiz compiled;
+    compiled.append(source, 0, source.count());
+    SessionPlan plan(SessionPlan::Request::sequential(1));
+    plan.extendSequential(compiled.count());
+    results << measure("grade.submit", size, minMs, [&]() {
+        int score = 0;
+        for (int i = 0; i < plan.count(); ++i) {
+            const SessionPlan::Item &item = plan.item(i);
+            score += compiled.points(item.question, quint8(1u << item.order[i % 4]));
+        }
+        Q_UNUSED(score);
+    });
+
+    // Пакетная проверка: 1000 бланков на банк
+    const GradingEngine engine(source);
+    QByteArray sheets(qsizetype(1000) * engine.stride(), 0);
+    std::mt19937 rng(size);
+    for (char &answer : sheets)
+        answer = static_cast<char>(rng() & 0x0f);
+    results << measure("grade.batch1000", size, minMs, [&]() { engine.gradeBatch(sheets); });
+
+    // QuizCli dedupe: подписи, корзины и разбиение на группы
+    results << measure("dedupe", size, minMs, [&]() {
+        DuplicateIndex index;
+        index.reserve(questions.size());
+        for (int i = 0; i < questions.size(); ++i)
+            index.add(i, questions[i]);
+        index.clusters(0.8);
+    });
+
+    // QuizViewer: поиск на каждое нажатие клавиши — одна-две буквы (только
+    // целые слова), префикс от kMinPrefix букв и запрос из двух слов
+    SearchIndex searchIndex;
+    results << measure("search.build", size, minMs, [&]() {
+        searchIndex.clear();
+        for (int i = 0; i < questions.size(); ++i)
+            searchIndex.add(i, questions[i]);
+    });
+    // Первое слово текста — номер вопроса, запросы берутся из следующих
+    const QStringList words = SearchIndex::tokenize(questions[0].text);
+    if (words.size() >= 3) {
+        const QString typed = words[1].left(SearchIndex::kMinPrefix);
+        results << measure("search.short", size, minMs, [&]() { searchIndex.search(typed.left(2)); });
+        results << measure("search.prefix", size, minMs, [&]() { searchIndex.search(typed); });
+        results << measure("search.words", size, minMs, [&]() { searchIndex.search(words[1] + " " + words[2]); });
+    }
+
+    // QuizTaker, адаптивный тест: 2PL-параметры со случайным разбросом, выбор
+    // следующего вопроса при меняющейся оценке уровня, 50 вопросов на сессию
+    QVector<ItemParameters> items(size);
+    std::normal_distribution<float> normal;
+    for (ItemParameters &item : items) {
+        item.a = 0.5f + float(rng() % 2000) / 1000.0f;
+        item.b = normal(rng);
+    }
+    AdaptiveSelector selector;
+    results << measure("adaptive.build", size, minMs, [&]() { selector.build(items); });
+    results << measure("adaptive.session50", size, minMs, [&]() {
+        selector.reset();
+        AbilityEstimate ability;
+        for (int i = 0; i < 50; ++i) {
+            const int question = selector.next(ability.theta());
+            if (question < 0)
+                break;
+            selector.take(question);
+            ability.update(items[question], (rng() & 1) != 0);
+        }
+    });
+
+    // Один выбор против просмотра всего банка при той же оценке
+    selector.reset();
+    std::uniform_real_distribution<double> thetas(-3.0, 3.0);
+    results << measure("adaptive.select", size, minMs, [&]() { selector.next(thetas(rng)); });
+    results << measure("adaptive.scan", size, minMs, [&]() {
+        const double theta = thetas(rng);
+        double best = -1.0;
+        for (const ItemParameters &item : items)
+            best = std::max(best, Irt::information(item, theta));
+        Q_UNUSED(best);
+    });
+}
+
+// Выбор AdaptiveSelector должен совпадать с полным перебором свободных
+// вопросов по информации (при равной информации допустим любой из них)
+bool checkAdaptiveSelector(int size)
+{
+    std::mt19937 rng(size);
+    std::normal_distribution<float> normal;
+    QVector<ItemParameters> items(size);
+    for (ItemParameters &item : items) {
+        item.a = 0.5f + float(rng() % 2000) / 1000.0f;
+        item.b = normal(rng);
+    }
+
+    AdaptiveSelector selector;
+    selector.build(items);
+    QVector<bool> taken(size, false);
+    std::uniform_real_distribution<double> thetas(-4.0, 4.0);
+    int mismatches = 0;
+    const int steps = qMin(size, 2000);
+    for (int step = 0; step < steps; ++step) {
+        const double theta = thetas(rng);
+        double best = -1.0;
+        for (int i = 0; i < size; ++i) {
+            if (!taken[i])
+                best = std::max(best, Irt::information(items[i], theta));
+        }
+        const int chosen = selector.next(theta);
+        if (chosen < 0 || taken[chosen] || Irt::information(items[chosen], theta) < best * (1.0 - 1e-9)) {
+            ++mismatches;
+            continue;
+        }
+        // Вопросы берутся как в сессии, чтобы проверить и обход занятых
+        selector.take(chosen);
+        taken[chosen] = true;
+    }
+
+    err() << "adaptive.check [" << size << "]: " << steps << " выборов, расхождений " << mismatches << "\n";
+    return mismatches == 0;
+}
+
+// json -> quizbin -> json должен давать тот же файл, а quizbin с числом
+// блоков, не соответствующим числу вопросов, — отвергаться при открытии
+bool checkQuizRoundTrip(int size, const QString &dir)
+{
+    const QString jsonPath = dir + QString("/roundtrip-%1.json").arg(size);
+    const QString binPath = dir + QString("/roundtrip-%1.quizbin").arg(size);
+    const QString backPath = dir + QString("/roundtrip-%1.back.json").arg(size);
+
+    QuizSource json;
+    QuizSource binary;
+    QuizSource back;
+    bool ok = QuizSource::save(makeQuestions(size), jsonPath) && json.open(jsonPath)
+              && QuizSource::save(json.questions(), binPath) && binary.open(binPath)
+              && QuizSource::save(binary.questions(), backPath) && back.open(backPath);
+    if (ok) {
+        QFile original(jsonPath);
+        QFile restored(backPath);
+        ok = original.open(QIODevice::ReadOnly) && restored.open(QIODevice::ReadOnly)
+             && original.readAll() == restored.readAll();
+    }
+
+    QFile corrupted(binPath);
+    if (ok && corrupted.open(QIODevice::ReadWrite) && corrupted.seek(16)) {
+        // Поле числа блоков в заголовке
+        const uchar extra[4] = {0xff, 0xff, 0x00, 0x00};
+        corrupted.write(reinterpret_cast<const char *>(extra), 4);
+        corrupted.close();
+        QuizBinary rejected;
+        ok = !rejected.open(binPath);
+    }
+
+    err() << "roundtrip [" << size << "]: " << (ok ? "совпадает" : "ОШИБКА") << "\n";
+    return ok;
+}
+
+void benchScores(int size, int minMs, const QString &dir, QVector<Result> &results)
+{
+    const QString journalPath = dir + QString("/scores-%1.d").arg(size);
+    {
+        ScoreJournal journal(journalPath);
+        QuizGenerator::Options options;
+        options.seed = quint64(size);
+        options.quizCount = 20;
+        options.userCount = qMax(1, size / 10);
+        QuizGenerator generator(options);
+        QByteArray lines;
+        for (int i = 0; i < size; ++i) {
+            lines += JournalLine::encode(generator.nextScore().toJson());
+            if (lines.size() > (1 << 20)) {
+                journal.appendBatch(lines);
+                lines.clear();
+            }
+        }
+        if (!lines.isEmpty())
+            journal.appendBatch(lines);
+    }
+
+    // Холодная загрузка таблицы рекордов: чтение журнала и построение рейтинга
+    QVector<ScoreRecord> records;
+    LeaderboardIndex board;
+    results << measure("scores.load", size, minMs, [&]() {
+        ScoreJournal journal(journalPath);
+        records.clear();
+        board = LeaderboardIndex();
+        for (const QJsonObject &obj : journal.readAll()) {
+            records.append(ScoreRecord::fromJson(obj));
+            board.insert(records.size() - 1, records.last().score);
+        }
+    });
+
+    // ScoreStore::insert: статистика вопросов по записям с 20 ответами каждая
+    QVector<ScoreRecord> answered(qMin(size, 100000));
+    std::mt19937 rng(size);
+    for (ScoreRecord &record : answered) {
+        for (int k = 0; k < 20; ++k) {
+            ScoreRecord::Answer answer;
+            answer.question = int(rng() % 1000);
+            answer.mask = quint8(rng() & 0x0f);
+            answer.key = quint8(1u << (answer.question % 4));
+            record.answers.append(answer);
+            record.times.append(int(rng() % 30000));
+        }
+    }
+    results << measure("itemstats.add", answered.size(), minMs, [&]() {
+        ItemStats stats(1000);
+        for (const ScoreRecord &record : answered)
+            stats.add(record);
+    });
+
+    // QuizTaker::loadScoresToTable: первая страница модели и место игрока
+    results << measure("scores.page", size, minMs, [&]() {
+        int checksum = 0;
+        for (int row = 0; row < qMin(100, board.count()); ++row)
+            checksum += records[board.recordAt(row)].score;
+        checksum += board.rankOf(100);
+        Q_UNUSED(checksum);
+    });
+}
+
+// Дочерний процесс проверки журнала: count записей {writer, seq} по одной,
+// с короткой блокировкой, чтобы чаще срабатывал отзыв и повтор записи.
+// В stdout — число повторов и число записанных этим процессом пакетов
+int runJournalWriter(const QString &dirPath, int writer, int count)
+{
+    ScoreJournal journal(dirPath);
+    journal.setLockTimeout(1);
+    int retries = 0;
+    for (int seq = 0; seq < count; ++seq) {
+        QJsonObject record;
+        record["writer"] = writer;
+        record["seq"] = seq;
+        while (!journal.append(record))
+            ++retries;
+    }
+    QTextStream(stdout) << retries << ' ' << journal.commitCount() << "\n";
+    return 0;
+}
+
+struct WritersRun
+{
+    qint64 elapsedMs = 0;
+    int records = 0;
+    int commits = 0;
+    int retries = 0;
+    bool ok = false;
+};
+
+// writers процессов пишут в один журнал; каждая запись должна оказаться в
+// нём ровно один раз. Время считается от запуска первого процесса
+WritersRun runJournalWriters(int writers, int count, const QString &journalPath)
+{
+    WritersRun run;
+    run.records = writers * count;
+    run.ok = true;
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QProcess *> processes;
+    for (int writer = 0; writer < writers; ++writer) {
+        QProcess *process = new QProcess;
+        process->start(QCoreApplication::applicationFilePath(),
+                       {"--journal-writer", QString("%1,%2,%3").arg(journalPath).arg(writer).arg(count)});
+        processes.append(process);
+    }
+    for (QProcess *process : processes) {
+        if (!process->waitForFinished(-1) || process->exitCode() != 0)
+            run.ok = false;
+        const QList<QByteArray> fields = process->readAllStandardOutput().trimmed().split(' ');
+        if (fields.size() == 2) {
+            run.retries += fields[0].toInt();
+            run.commits += fields[1].toInt();
+        }
+        delete process;
+    }
+    run.elapsedMs = qMax<qint64>(1, timer.elapsed());
+
+    QVector<QVector<int>> seen(writers, QVector<int>(count, 0));
+    int foreign = 0;
+    for (const QJsonObject &record : ScoreJournal(journalPath).readAll()) {
+        const int writer = record["writer"].toInt(-1);
+        const int seq = record["seq"].toInt(-1);
+        if (writer < 0 || writer >= writers || seq < 0 || seq >= count) {
+            ++foreign;
+            continue;
+        }
+        ++seen[writer][seq];
+    }
+    int lost = 0;
+    int duplicated = 0;
+    for (const QVector<int> &row : seen) {
+        for (int copies : row) {
+            lost += copies == 0 ? 1 : 0;
+            duplicated += copies > 1 ? copies - 1 : 0;
+        }
+    }
+
+    err() << "journal.writers [" << writers << "x" << count << "]: " << run.elapsedMs << " мс, "
+          << qint64(run.records) * 1000 / run.elapsedMs << " записей/с, fsync на запись "
+          << QString::number(double(run.commits) / run.records, 'f', 3) << ", повторов " << run.retries
+          << ", потеряно " << lost << ", задвоено " << duplicated << ", чужих " << foreign << "\n";
+    run.ok = run.ok && lost == 0 && duplicated == 0 && foreign == 0;
+    return run;
+}
+
+// Один писатель против writers: записи не теряются и не задваиваются, а при
+// нескольких писателях фиксации объединяются в пакеты — fsync заметно меньше,
+// чем записей, и пропускная способность не падает ниже одиночной
+bool checkJournalWriters(int writers, int count, const QString &dir)
+{
+    const WritersRun single = runJournalWriters(1, count, dir + "/writers-1.d");
+    const WritersRun many = runJournalWriters(writers, count, dir + QString("/writers-%1.d").arg(writers));
+    if (!single.ok || !many.ok)
+        return false;
+
+    const double singleRate = double(single.records) / single.elapsedMs;
+    const double manyRate = double(many.records) / many.elapsedMs;
+    const bool batched = writers < 2 || many.commits < many.records * 0.9;
+    err() << "journal.writers: ускорение x" << QString::number(manyRate / singleRate, 'f', 2)
+          << (batched ? "" : ", ПАКЕТЫ НЕ ОБЪЕДИНЯЮТСЯ") << "\n";
+    return batched && manyRate >= singleRate;
+}
+
+QJsonDocument toJson(const QVector<Result> &results)
+{
+    QJsonArray array;
+    for (const Result &result : results) {
+        QJsonObject obj;
+        obj["name"] = result.name;
+        obj["size"] = result.size;
+        obj["ns"] = double(result.nsecs);
+        obj["iterations"] = result.iterations;
+        array.append(obj);
+    }
+    QJsonObject root;
+    root["qt"] = QString(qVersion());
+    root["results"] = array;
+    return QJsonDocument(root);
+}
+
+// Возвращает число замедлившихся замеров
+int compareWithBaseline(const QVector<Result> &results, const QString &baselinePath, double threshold)
+{
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err() << "Не удалось открыть базовый прогон " << baselinePath << "\n";
+        return -1;
+    }
+
+    QHash<QString, double> baseline;
+    for (const QJsonValue &value : QJsonDocument::fromJson(file.readAll()).object()["results"].toArray()) {
+        const QJsonObject obj = value.toObject();
+        baseline.insert(obj["name"].toString() + "/" + QString::number(obj["size"].toInt()), obj["ns"].toDouble());
+    }
+
+    int regressions = 0;
+    for (const Result &result : results) {
+        const QString key = result.name + "/" + QString::number(result.size);
+        if (!baseline.contains(key) || baseline[key] <= 0)
+            continue;
+        const double ratio = result.nsecs / baseline[key];
+        if (ratio > 1.0 + threshold) {
+            err() << "ЗАМЕДЛЕНИЕ " << key << ": x" << QString::number(ratio, 'f', 2) << "\n";
+            ++regressions;
+        }
+    }
+    return regressions;
+}
+
+QVector<int> parseSizes(const QString &text)
+{
+    QVector<int> sizes;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts))
+        sizes.append(part.trimmed().toInt());
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Замеры загрузки, сохранения, проверки и таблицы рекордов.");
+    parser.addHelpOption();
+    const QCommandLineOption sizesOption("sizes", "Размеры банков через запятую", "N,...", "1000,10000,100000");
+    const QCommandLineOption scoresOption("scores", "Размеры журнала результатов через запятую", "N,...", "1000,100000");
+    const QCommandLineOption minTimeOption("min-time", "Минимальное время на замер, мс", "ms", "200");
+    const QCommandLineOption outputOption("output", "Записать результаты в файл вместо stdout", "file");
+    const QCommandLineOption baselineOption("baseline", "Сравнить с сохранённым прогоном", "file");
+    const QCommandLineOption thresholdOption("threshold", "Допустимое замедление, доля", "x", "0.10");
+    const QCommandLineOption writersOption("journal-writers", "Проверить журнал: N процессов по M записей", "N,M");
+    QCommandLineOption writerOption("journal-writer", "Служебный режим проверки журнала", "dir,writer,count");
+    writerOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOptions({sizesOption, scoresOption, minTimeOption, outputOption, baselineOption, thresholdOption,
+                       writersOption, writerOption});
+    parser.process(app);
+
+    if (parser.isSet(writerOption)) {
+        // Путь к каталогу может сам содержать запятые — номера берутся с конца
+        const QString value = parser.value(writerOption);
+        return runJournalWriter(value.section(',', 0, -3), value.section(',', -2, -2).toInt(),
+                                value.section(',', -1).toInt());
+    }
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        err() << "Не удалось создать временный каталог\n";
+        return 1;
+    }
+
+    const int minMs = parser.value(minTimeOption).toInt();
+    QVector<Result> results;
+    for (int size : parseSizes(parser.value(sizesOption))) {
+        if (!checkQuizRoundTrip(size, dir.path()) || !checkAdaptiveSelector(size))
+            return 1;
+        benchQuiz(size, minMs, dir.path(), results);
+    }
+    for (int size : parseSizes(parser.value(scoresOption)))
+        benchScores(size, minMs, dir.path(), results);
+
+    if (parser.isSet(writersOption)) {
+        const QVector<int> counts = parseSizes(parser.value(writersOption));
+        if (counts.size() != 2 || !checkJournalWriters(counts[0], counts[1], dir.path()))
+            return 1;
+    }
+
+    const QByteArray json = toJson(results).toJson();
+    if (parser.isSet(outputOption)) {
+        QFile out(parser.value(outputOption));
+        if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+            err() << "Не удалось записать " << parser.value(outputOption) << "\n";
+            return 1;
+        }
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    if (parser.isSet(baselineOption)) {
+        const int regressions = compareWithBaseline(results, parser.value(baselineOption),
+                                                    parser.value(thresholdOption).toDouble());
+        if (regressions != 0)
+            return 1;
+    }
+    return 0;
+}
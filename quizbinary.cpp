@@ -0,0 +1,288 @@
+#include "quizbinary.h"
+
+#include <QSaveFile>
+#include <QHash>
+#include <QVector>
+#include <QtEndian>
+
+namespace {
+
+const char kMagic[4] = {'M', 'S', 'Q', 'Z'};
+const quint32 kVersion = 1;
+const int kHeaderSize = 64;
+const int kBlockEntrySize = 16;
+const int kStringEntrySize = 16;
+
+void putU8(QByteArray &out, quint8 value)
+{
+    out.append(static_cast<char>(value));
+}
+
+void putU32(QByteArray &out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+
+void putU64(QByteArray &out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 8);
+}
+
+quint32 getU32(const uchar *ptr)
+{
+    return qFromLittleEndian<quint32>(ptr);
+}
+
+quint64 getU64(const uchar *ptr)
+{
+    return qFromLittleEndian<quint64>(ptr);
+}
+
+} // namespace
+
+bool QuizBinary::isCompiledFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    return file.read(4) == QByteArray(kMagic, 4);
+}
+
+bool QuizBinary::write(const QVector<Question> &questions, const QString &fileName, QString *error)
+{
+    QHash<QString, quint32> stringIds;
+    QVector<QString> strings;
+    auto intern = [&](const QString &text) -> quint32 {
+        auto it = stringIds.constFind(text);
+        if (it != stringIds.constEnd())
+            return it.value();
+        const quint32 id = strings.size();
+        stringIds.insert(text, id);
+        strings.append(text);
+        return id;
+    };
+
+    const int count = questions.size();
+    const int blockCount = (count + kBlockSize - 1) / kBlockSize;
+
+    QByteArray difficulties;
+    difficulties.reserve(count);
+    QVector<QByteArray> blocks;
+    blocks.reserve(blockCount);
+    QVector<quint32> rawSizes;
+
+    for (int first = 0; first < count; first += kBlockSize) {
+        const int inBlock = qMin(kBlockSize, count - first);
+        QByteArray records;
+        QVector<quint32> offsets;
+        for (int i = first; i < first + inBlock; ++i) {
+            const Question &q = questions[i];
+            const QVector<int> correct = q.correctIndexes();
+
+            offsets.append(inBlock * 4 + records.size());
+            putU32(records, intern(q.text));
+            putU8(records, Question::kOptionCount);
+            for (const QString &option : q.options)
+                putU32(records, intern(option));
+            putU8(records, static_cast<quint8>(correct.size()));
+            for (int idx : correct)
+                putU8(records, static_cast<quint8>(idx));
+            putU8(records, q.difficulty);
+            difficulties.append(static_cast<char>(q.difficulty));
+        }
+
+        QByteArray raw;
+        for (quint32 offset : offsets)
+            putU32(raw, offset);
+        raw += records;
+        rawSizes.append(raw.size());
+        blocks.append(qCompress(raw));
+    }
+
+    QByteArray stringTable;
+    QByteArray stringData;
+    for (const QString &text : strings) {
+        const QByteArray utf8 = text.toUtf8();
+        putU64(stringTable, stringData.size());
+        putU32(stringTable, utf8.size());
+        putU32(stringTable, 0);
+        stringData += utf8;
+    }
+
+    const quint64 difficultyOffset = kHeaderSize;
+    const quint64 blockTableOffset = difficultyOffset + difficulties.size();
+    const quint64 stringTableOffset = blockTableOffset + quint64(blockCount) * kBlockEntrySize;
+    const quint64 stringDataOffset = stringTableOffset + stringTable.size();
+    quint64 blockOffset = stringDataOffset + stringData.size();
+
+    QByteArray blockTable;
+    for (int b = 0; b < blockCount; ++b) {
+        putU64(blockTable, blockOffset);
+        putU32(blockTable, blocks[b].size());
+        putU32(blockTable, rawSizes[b]);
+        blockOffset += blocks[b].size();
+    }
+
+    QByteArray header(kMagic, 4);
+    putU32(header, kVersion);
+    putU32(header, count);
+    putU32(header, kBlockSize);
+    putU32(header, blockCount);
+    putU32(header, strings.size());
+    putU64(header, difficultyOffset);
+    putU64(header, blockTableOffset);
+    putU64(header, stringTableOffset);
+    putU64(header, stringDataOffset);
+    putU64(header, 0);
+
+    QSaveFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = out.errorString();
+        return false;
+    }
+    out.write(header);
+    out.write(difficulties);
+    out.write(blockTable);
+    out.write(stringTable);
+    out.write(stringData);
+    for (const QByteArray &block : blocks)
+        out.write(block);
+
+    if (!out.commit()) {
+        if (error)
+            *error = out.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool QuizBinary::open(const QString &fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+
+    size = file.size();
+    data = size >= kHeaderSize ? file.map(0, size) : nullptr;
+    if (!data || QByteArray(reinterpret_cast<const char *>(data), 4) != QByteArray(kMagic, 4)
+        || getU32(data + 4) != kVersion) {
+        error = "Файл не является скомпилированной викториной.";
+        data = nullptr;
+        return false;
+    }
+
+    questionCount = getU32(data + 8);
+    blockCount = getU32(data + 16);
+    stringCount = getU32(data + 20);
+    difficultyOffset = getU64(data + 24);
+    blockTableOffset = getU64(data + 32);
+    stringTableOffset = getU64(data + 40);
+    stringDataOffset = getU64(data + 48);
+
+    // Число блоков должно покрывать вопросы ровно: иначе question() прочитал
+    // бы запись таблицы блоков за её пределами
+    const quint64 expectedBlocks = (quint64(getU32(data + 8)) + kBlockSize - 1) / kBlockSize;
+    if (getU32(data + 12) != quint32(kBlockSize)
+        || questionCount < 0 || quint64(getU32(data + 16)) != expectedBlocks
+        || difficultyOffset + questionCount > quint64(size)
+        || blockTableOffset + quint64(blockCount) * kBlockEntrySize > quint64(size)
+        || stringTableOffset + quint64(stringCount) * kStringEntrySize > quint64(size)
+        || stringDataOffset > quint64(size)) {
+        error = "Повреждён заголовок скомпилированной викторины.";
+        data = nullptr;
+        return false;
+    }
+
+    cachedBlockIndex = -1;
+    return true;
+}
+
+int QuizBinary::difficulty(int index) const
+{
+    if (!data || index < 0 || index >= questionCount)
+        return 1;
+    return data[difficultyOffset + index];
+}
+
+QString QuizBinary::string(quint32 id) const
+{
+    if (id >= stringCount)
+        return QString();
+
+    const uchar *entry = data + stringTableOffset + quint64(id) * kStringEntrySize;
+    const quint64 offset = stringDataOffset + getU64(entry);
+    const quint32 length = getU32(entry + 8);
+    if (offset + length > quint64(size))
+        return QString();
+    return QString::fromUtf8(reinterpret_cast<const char *>(data + offset), length);
+}
+
+const QByteArray &QuizBinary::block(int blockIndex) const
+{
+    if (blockIndex != cachedBlockIndex) {
+        const uchar *entry = data + blockTableOffset + quint64(blockIndex) * kBlockEntrySize;
+        const quint64 offset = getU64(entry);
+        const quint32 compressed = getU32(entry + 8);
+        if (offset + compressed <= quint64(size))
+            cachedBlock = qUncompress(data + offset, compressed);
+        else
+            cachedBlock.clear();
+        cachedBlockIndex = blockIndex;
+    }
+    return cachedBlock;
+}
+
+Question QuizBinary::question(int index) const
+{
+    Question q;
+    if (!data || index < 0 || index >= questionCount)
+        return q;
+
+    const QByteArray &raw = block(index / kBlockSize);
+    const int slot = index % kBlockSize;
+    if (raw.size() < (slot + 1) * 4)
+        return q;
+
+    const uchar *base = reinterpret_cast<const uchar *>(raw.constData());
+    const uchar *end = base + raw.size();
+    const uchar *ptr = base + getU32(base + slot * 4);
+    auto has = [&](int bytes) { return ptr + bytes <= end; };
+
+    if (!has(5))
+        return q;
+    q.text = string(getU32(ptr));
+    ptr += 4;
+
+    const int optionCount = *ptr++;
+    for (int i = 0; i < optionCount && has(4); ++i, ptr += 4) {
+        if (i < Question::kOptionCount)
+            q.options[i] = string(getU32(ptr));
+    }
+
+    if (has(1)) {
+        const int correctCount = *ptr++;
+        for (int i = 0; i < correctCount && has(1); ++i) {
+            const int idx = *ptr++;
+            if (idx < Question::kOptionCount)
+                q.correctMask |= 1u << idx;
+        }
+    }
+    q.difficulty = has(1) ? *ptr : static_cast<quint8>(difficulty(index));
+    return q;
+}
+
+QVector<Question> QuizBinary::questions() const
+{
+    QVector<Question> all;
+    all.reserve(questionCount);
+    for (int i = 0; i < questionCount; ++i)
+        all.append(question(i));
+    return all;
+}
@@ -0,0 +1,56 @@
+#ifndef QUIZBINARY_H
+#define QUIZBINARY_H
+
+#include <QString>
+#include <QFile>
+#include <QVector>
+#include <QByteArray>
+
+#include "question.h"
+
+// Скомпилированный формат викторины (*.quizbin), все числа little-endian:
+//   заголовок         — сигнатура, версия, количества и смещения секций;
+//   сложности         — по байту на вопрос (для подсчёта времени без распаковки);
+//   таблица блоков    — смещение, сжатый и исходный размер каждого блока;
+//   таблица строк     — смещение и длина каждой строки пула;
+//   пул строк         — UTF-8 без сжатия, одинаковые строки хранятся один раз;
+//   блоки             — qCompress по kBlockSize вопросов: ссылки на строки пула.
+// Файл открывается через QFile::map, вопрос распаковывается только при обращении.
+class QuizBinary
+{
+public:
+    static constexpr int kBlockSize = 64;
+
+    static bool isCompiledFile(const QString &fileName);
+    static bool write(const QVector<Question> &questions, const QString &fileName, QString *error = nullptr);
+
+    bool open(const QString &fileName);
+    QString errorString() const { return error; }
+
+    int count() const { return questionCount; }
+    int difficulty(int index) const;
+    Question question(int index) const;
+    QVector<Question> questions() const;
+
+private:
+    QString string(quint32 id) const;
+    const QByteArray &block(int blockIndex) const;
+
+    QFile file;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+    QString error;
+
+    int questionCount = 0;
+    int blockCount = 0;
+    quint32 stringCount = 0;
+    quint64 difficultyOffset = 0;
+    quint64 blockTableOffset = 0;
+    quint64 stringTableOffset = 0;
+    quint64 stringDataOffset = 0;
+
+    mutable int cachedBlockIndex = -1;
+    mutable QByteArray cachedBlock;
+};
+
+#endif // QUIZBINARY_H
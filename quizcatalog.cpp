@@ -0,0 +1,150 @@
+#include "quizcatalog.h"
+#include "journalline.h"
+#include "quizsource.h"
+#include "scoring.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <algorithm>
+
+bool QuizCatalog::Entry::matches(const QFileInfo &info) const
+{
+    return size == info.size() && modified == info.lastModified().toMSecsSinceEpoch();
+}
+
+QJsonObject QuizCatalog::Entry::toJson() const
+{
+    QJsonObject obj;
+    obj["path"] = path;
+    obj["modified"] = double(modified);
+    obj["size"] = double(size);
+    obj["hash"] = QString::fromLatin1(hash);
+    obj["questions"] = questions;
+    obj["difficulty"] = QJsonArray{byDifficulty[0], byDifficulty[1], byDifficulty[2], byDifficulty[3]};
+    obj["seconds"] = seconds;
+    if (!error.isEmpty())
+        obj["error"] = error;
+    return obj;
+}
+
+QuizCatalog::Entry QuizCatalog::Entry::fromJson(const QJsonObject &obj)
+{
+    Entry entry;
+    entry.path = obj["path"].toString();
+    entry.modified = qint64(obj["modified"].toDouble());
+    entry.size = qint64(obj["size"].toDouble());
+    entry.hash = obj["hash"].toString().toLatin1();
+    entry.questions = obj["questions"].toInt();
+    const QJsonArray histogram = obj["difficulty"].toArray();
+    for (int i = 0; i < 4 && i < histogram.size(); ++i)
+        entry.byDifficulty[i] = histogram[i].toInt();
+    entry.seconds = obj["seconds"].toInt();
+    entry.error = obj["error"].toString();
+    return entry;
+}
+
+QString QuizCatalog::defaultPath()
+{
+    return "quizcatalog.log";
+}
+
+QuizCatalog::Entry QuizCatalog::scan(const QString &path, const Entry *previous)
+{
+    Entry entry;
+    entry.path = path;
+
+    const QFileInfo info(path);
+    entry.modified = info.lastModified().toMSecsSinceEpoch();
+    entry.size = info.size();
+
+    QFile file(path);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file)) {
+        entry.error = file.errorString();
+        return entry;
+    }
+    entry.hash = hash.result().toHex();
+    file.close();
+
+    if (previous && previous->hash == entry.hash && previous->error.isEmpty()) {
+        entry.questions = previous->questions;
+        std::copy(previous->byDifficulty, previous->byDifficulty + 4, entry.byDifficulty);
+        entry.seconds = previous->seconds;
+        return entry;
+    }
+
+    QuizSource quiz;
+    if (!quiz.open(path)) {
+        entry.error = quiz.errorString();
+        return entry;
+    }
+    // Для *.quizbin сложность читается из индекса без распаковки вопросов
+    entry.questions = quiz.count();
+    for (int i = 0; i < quiz.count(); ++i) {
+        const int level = quiz.difficulty(i);
+        ++entry.byDifficulty[level >= 1 && level <= 3 ? level : 0];
+    }
+    entry.seconds = Scoring::timeBudget(quiz, 0, quiz.count());
+    return entry;
+}
+
+bool QuizCatalog::load(const QString &fileName)
+{
+    byPath.clear();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    while (!file.atEnd()) {
+        QJsonObject record;
+        if (JournalLine::decode(file.readLine(), &record)) {
+            const Entry entry = Entry::fromJson(record);
+            byPath.insert(entry.path, entry);
+        }
+    }
+    return true;
+}
+
+bool QuizCatalog::save(const QString &fileName) const
+{
+    QByteArray lines;
+    for (const Entry &entry : byPath)
+        lines += JournalLine::encode(entry.toJson());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(lines) != lines.size())
+        return false;
+    return file.commit();
+}
+
+const QuizCatalog::Entry *QuizCatalog::find(const QString &path) const
+{
+    const auto it = byPath.constFind(path);
+    return it == byPath.constEnd() ? nullptr : &it.value();
+}
+
+QVector<QuizCatalog::Entry> QuizCatalog::entriesUnder(const QString &dirPath) const
+{
+    const QString prefix = QDir(dirPath).absolutePath() + '/';
+    QVector<Entry> entries;
+    for (const Entry &entry : byPath) {
+        if (entry.path.startsWith(prefix))
+            entries.append(entry);
+    }
+    return entries;
+}
+
+void QuizCatalog::insert(const Entry &entry)
+{
+    byPath.insert(entry.path, entry);
+}
+
+void QuizCatalog::remove(const QString &path)
+{
+    byPath.remove(path);
+}
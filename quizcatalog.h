@@ -0,0 +1,54 @@
+#ifndef QUIZCATALOG_H
+#define QUIZCATALOG_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QJsonObject>
+
+class QFileInfo;
+
+// Каталог библиотеки викторин: по каждому файлу хранится всё, что нужно для
+// списка, поэтому сами файлы при открытии библиотеки не разбираются.
+// Каталог лежит в одном файле строками JournalLine и перезаписывается
+// целиком через QSaveFile.
+class QuizCatalog
+{
+public:
+    struct Entry
+    {
+        QString path;
+        qint64 modified = 0;                // мс от эпохи, UTC
+        qint64 size = 0;
+        QByteArray hash;                    // SHA-1 содержимого, hex
+        int questions = 0;
+        int byDifficulty[4] = {0, 0, 0, 0}; // [0] — неизвестная сложность
+        int seconds = 0;
+        QString error;                      // файл не разобрался
+
+        bool matches(const QFileInfo &info) const;
+        QJsonObject toJson() const;
+        static Entry fromJson(const QJsonObject &obj);
+    };
+
+    static QString defaultPath();
+
+    // Разбор одного файла. Если содержимое совпало с previous (файл только
+    // «тронули»), счётчики берутся из previous без разбора.
+    static Entry scan(const QString &path, const Entry *previous = nullptr);
+
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+    int count() const { return byPath.size(); }
+    const Entry *find(const QString &path) const;
+    QVector<Entry> entriesUnder(const QString &dirPath) const;
+    void insert(const Entry &entry);
+    void remove(const QString &path);
+
+private:
+    QHash<QString, Entry> byPath;
+};
+
+#endif // QUIZCATALOG_H
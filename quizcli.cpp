@@ -0,0 +1,547 @@
+#include "quizsource.h"
+#include "quizdeltalog.h"
+#include "scorestore.h"
+#include "scorejournal.h"
+#include "journalline.h"
+#include "scoring.h"
+#include "gradingengine.h"
+#include "compiledquiz.h"
+#include "sessionplan.h"
+#include "duplicateindex.h"
+#include "quizimporter.h"
+#include "itemcalibration.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <cmath>
+#include <random>
+
+// QuizCli — консольный клиент QuizCore для пакетной обработки без дисплея.
+// Работает с теми же файлами викторин и журналом результатов scores.d/,
+// что и QuizApp, поэтому запускать его нужно из того же рабочего каталога.
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Викторина в том виде, в каком её видит приложение: файл плюс несвёрнутые правки
+bool openQuiz(const QString &fileName, QuizSource *quiz)
+{
+    if (!quiz->open(fileName)) {
+        err() << "Ошибка чтения " << fileName << ": " << quiz->errorString() << "\n";
+        return false;
+    }
+    quiz->setOverrides(QuizDeltaLog::read(fileName));
+    return true;
+}
+
+int validateQuiz(const QStringList &args)
+{
+    if (args.size() != 1) {
+        err() << "Использование: QuizCli validate <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    int problems = 0;
+    for (int i = 0; i < quiz.count(); ++i) {
+        const Question q = quiz.question(i);
+        if (!q.isComplete()) {
+            out() << "Вопрос " << i + 1 << ": пустой текст, пустой вариант или нет правильного ответа\n";
+            ++problems;
+        }
+        if (q.difficulty < 1 || q.difficulty > 3) {
+            out() << "Вопрос " << i + 1 << ": недопустимая сложность " << int(q.difficulty) << "\n";
+            ++problems;
+        }
+    }
+
+    if (quiz.count() == 0) {
+        out() << "В викторине нет вопросов\n";
+        ++problems;
+    }
+
+    out() << "Вопросов: " << quiz.count() << ", ошибок: " << problems << "\n";
+    return problems == 0 ? 0 : 1;
+}
+
+int printStats(const QStringList &args)
+{
+    if (args.size() != 1) {
+        err() << "Использование: QuizCli stats <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    int byDifficulty[4] = {0, 0, 0, 0};
+    int multipleChoice = 0;
+    for (int i = 0; i < quiz.count(); ++i) {
+        const Question q = quiz.question(i);
+        ++byDifficulty[q.difficulty >= 1 && q.difficulty <= 3 ? q.difficulty : 0];
+        if (q.correctIndexes().size() > 1)
+            ++multipleChoice;
+    }
+
+    const int seconds = Scoring::timeBudget(quiz, 0, quiz.count());
+    out() << "Формат: " << (quiz.isCompiled() ? "quizbin" : "json") << "\n"
+          << "Вопросов: " << quiz.count() << "\n";
+    for (int level = 1; level <= 3; ++level)
+        out() << "  " << Question::difficultyName(level) << ": " << byDifficulty[level] << "\n";
+    if (byDifficulty[0] > 0)
+        out() << "  " << Question::difficultyName(0) << ": " << byDifficulty[0] << "\n";
+    out() << "С несколькими правильными ответами: " << multipleChoice << "\n"
+          << "Максимальный балл: " << Scoring::maxScore(quiz) << "\n"
+          << "Время на прохождение: " << seconds / 60 << " мин " << seconds % 60 << " с\n";
+    return 0;
+}
+
+// Файл ответов: [{"name": "...", "answers": [[0, 2], [1], ...]}, ...],
+// индексы вариантов — в исходном порядке вопроса в файле викторины
+int gradeAnswers(const QStringList &args, bool save)
+{
+    if (args.size() != 2) {
+        err() << "Использование: QuizCli grade [--save] <викторина> <ответы.json>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    QFile file(args[1]);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err() << "Ошибка чтения " << args[1] << ": " << file.errorString() << "\n";
+        return 1;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isArray()) {
+        err() << "Ошибка в файле ответов (байт " << parseError.offset << "): "
+              << (parseError.error != QJsonParseError::NoError ? parseError.errorString()
+                                                               : QString("ожидается массив"))
+              << "\n";
+        return 1;
+    }
+
+    const GradingEngine engine(quiz);
+    const QJsonArray entries = doc.array();
+    QByteArray sheets(qsizetype(entries.size()) * engine.stride(), 0);
+    for (int row = 0; row < entries.size(); ++row) {
+        const QJsonArray answers = entries[row].toObject()["answers"].toArray();
+        char *sheet = sheets.data() + qsizetype(row) * engine.stride();
+        for (int i = 0; i < engine.questionCount() && i < answers.size(); ++i) {
+            for (const QJsonValue &option : answers[i].toArray()) {
+                const int idx = option.toInt(-1);
+                if (idx >= 0 && idx < Question::kOptionCount)
+                    sheet[i] = static_cast<char>(sheet[i] | (1u << idx));
+            }
+        }
+    }
+    const QVector<int> scores = engine.gradeBatch(sheets);
+
+    QVector<quint8> keys(engine.questionCount());
+    for (int i = 0; i < engine.questionCount(); ++i)
+        keys[i] = quiz.question(i).correctMask;
+
+    // Все результаты сохраняются одним пакетом: одна блокировка и один fsync
+    // журнала вместо отдельной записи на каждого участника
+    const QString quizName = QFileInfo(args[0]).fileName();
+    QByteArray lines;
+    for (int row = 0; row < entries.size(); ++row) {
+        ScoreRecord record;
+        record.name = entries[row].toObject()["name"].toString();
+        record.quiz = quizName;
+        record.score = scores.value(row);
+        const char *sheet = sheets.constData() + qsizetype(row) * engine.stride();
+        const int answered = qMin(engine.questionCount(), entries[row].toObject()["answers"].toArray().size());
+        for (int i = 0; i < answered; ++i) {
+            ScoreRecord::Answer answer;
+            answer.question = i;
+            answer.mask = quint8(sheet[i]);
+            answer.key = keys[i];
+            record.answers.append(answer);
+        }
+
+        out() << record.name << "\t" << record.score << "\t" << engine.maxScore() << "\n";
+        if (save && !record.name.trimmed().isEmpty())
+            lines += JournalLine::encode(record.toJson());
+    }
+
+    if (!lines.isEmpty() && !ScoreJournal(ScoreJournal::defaultPath()).appendBatch(lines)) {
+        err() << "Не удалось сохранить результаты в " << ScoreJournal::defaultPath() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Пропускная способность проверки на случайных бланках: примерно половина
+// ответов совпадает с ключом, чтобы сравнение не было предсказуемым
+int benchGrading(const QStringList &args, int sheetCount)
+{
+    if (args.size() != 1 || sheetCount <= 0) {
+        err() << "Использование: QuizCli bench-grade [--sheets N] <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    const GradingEngine engine(quiz);
+    QVector<quint8> correct(engine.questionCount());
+    for (int i = 0; i < engine.questionCount(); ++i)
+        correct[i] = quiz.question(i).correctMask;
+
+    QByteArray sheets(qsizetype(sheetCount) * engine.stride(), 0);
+    std::mt19937 rng(12345);
+    for (int row = 0; row < sheetCount; ++row) {
+        char *sheet = sheets.data() + qsizetype(row) * engine.stride();
+        for (int i = 0; i < engine.questionCount(); ++i) {
+            const quint32 bits = rng();
+            sheet[i] = static_cast<char>((bits & 1) ? correct[i] : (bits >> 1) & 0x0f);
+        }
+    }
+
+    auto report = [sheetCount](const char *label, qint64 nsecs, qint64 checksum) {
+        const double perSecond = nsecs > 0 ? sheetCount * 1e9 / nsecs : 0;
+        out() << label << ": " << qint64(perSecond) << " бланков/с (" << nsecs / 1000000
+              << " мс, контрольная сумма " << checksum << ")\n";
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 checksum = 0;
+    const uchar *data = reinterpret_cast<const uchar *>(sheets.constData());
+    for (int row = 0; row < sheetCount; ++row)
+        checksum += engine.gradeScalar(data + qsizetype(row) * engine.stride());
+    report("побайтно, 1 поток", timer.nsecsElapsed(), checksum);
+
+    timer.restart();
+    checksum = 0;
+    for (int row = 0; row < sheetCount; ++row)
+        checksum += engine.grade(data + qsizetype(row) * engine.stride());
+    report("по 8 вопросов, 1 поток", timer.nsecsElapsed(), checksum);
+
+    timer.restart();
+    checksum = 0;
+    for (int score : engine.gradeBatch(sheets))
+        checksum += score;
+    report("по 8 вопросов, все ядра", timer.nsecsElapsed(), checksum);
+
+    out() << "Вопросов: " << engine.questionCount() << ", бланков: " << sheetCount << "\n";
+    return 0;
+}
+
+// Воспроизведение плана сессии по зерну (например, из поля plan записи результата)
+int printPlan(const QStringList &args, const SessionPlan::Request &request)
+{
+    if (args.size() != 1) {
+        err() << "Использование: QuizCli plan --seed S [--easy N --medium N --hard N] <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    CompiledQuiz compiled;
+    compiled.append(quiz, 0, quiz.count());
+    SessionPlan plan(request);
+    if (request.sampled) {
+        DifficultyIndex index;
+        index.append(compiled, 0, compiled.count());
+        plan.sample(index);
+    } else {
+        plan.extendSequential(compiled.count());
+    }
+
+    for (int i = 0; i < plan.count(); ++i) {
+        const SessionPlan::Item &item = plan.item(i);
+        out() << i + 1 << "\t" << item.question + 1 << "\t";
+        for (int k = 0; k < 4; ++k)
+            out() << item.order[k] + 1;
+        out() << "\t" << compiled.text(item.question) << "\n";
+    }
+    return 0;
+}
+
+// Группы почти одинаковых вопросов: номера через запятую и текст первого
+int printDuplicates(const QStringList &args, double threshold)
+{
+    if (args.size() != 1) {
+        err() << "Использование: QuizCli dedupe [--similarity 0.8] <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    QElapsedTimer timer;
+    timer.start();
+    DuplicateIndex index;
+    index.reserve(quiz.count());
+    for (int i = 0; i < quiz.count(); ++i)
+        index.add(i, quiz.question(i));
+    const QVector<QVector<int>> groups = index.clusters(threshold);
+
+    int repeated = 0;
+    for (const QVector<int> &group : groups) {
+        QStringList numbers;
+        for (int id : group)
+            numbers << QString::number(id + 1);
+        out() << numbers.join(',') << "\t" << quiz.question(group.first()).text << "\n";
+        repeated += group.size() - 1;
+    }
+    err() << "Групп: " << groups.size() << ", лишних вопросов: " << repeated
+          << ", время: " << timer.elapsed() << " мс\n";
+    return 0;
+}
+
+// Импорт CSV, GIFT или Markdown в файл викторины; отклонённые строки — в stderr
+int importQuestions(const QStringList &args)
+{
+    if (args.size() != 2) {
+        err() << "Использование: QuizCli import <вопросы.csv|.gift|.md> <викторина.json|.quizbin>\n";
+        return 2;
+    }
+
+    QuizImporter importer(args[0]);
+    QVector<Question> questions;
+    int imported = 0;
+    int rejected = 0;
+    qint64 elapsedMs = 0;
+
+    QEventLoop loop;
+    QObject::connect(&importer, &QuizImporter::questionsImported, &loop, [&](const QVector<Question> &batch) {
+        questions += batch;
+    });
+    QObject::connect(&importer, &QuizImporter::rowsRejected, &loop, [](const QStringList &errors) {
+        for (const QString &error : errors)
+            err() << error << "\n";
+    });
+    QObject::connect(&importer, &QuizImporter::finished, &loop, [&](int ok, int failed, qint64 ms, bool) {
+        imported = ok;
+        rejected = failed;
+        elapsedMs = ms;
+        loop.quit();
+    });
+    importer.start();
+    loop.exec();
+
+    const qint64 rowsPerSecond = qint64(imported + rejected) * 1000 / qMax<qint64>(1, elapsedMs);
+    out() << "Импортировано: " << imported << ", отклонено: " << rejected
+          << ", " << elapsedMs << " мс (" << rowsPerSecond << " записей/с)\n";
+    if (questions.isEmpty())
+        return 1;
+
+    QString error;
+    if (!QuizSource::save(questions, args[1], &error)) {
+        err() << "Не удалось сохранить " << args[1] << ": " << error << "\n";
+        return 1;
+    }
+    return rejected == 0 ? 0 : 1;
+}
+
+// Калибровка параметров вопросов по ответам из scores.d/
+int calibrateItems(const QStringList &args)
+{
+    if (args.size() != 1) {
+        err() << "Использование: QuizCli calibrate <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+    CompiledQuiz compiled;
+    compiled.append(quiz, 0, quiz.count());
+
+    const QString quizName = QFileInfo(args[0]).fileName();
+    const ScoreStore *store = ScoreStore::instance();
+    QVector<QVector<ItemCalibration::Response>> sessions;
+    int responses = 0;
+    for (int id = 0; id < store->recordCount(); ++id) {
+        if (store->record(id).quiz != quizName)
+            continue;
+        const QVector<ItemCalibration::Response> session = ItemCalibration::responsesOf(store->record(id));
+        if (session.isEmpty())
+            continue;
+        sessions.append(session);
+        responses += session.size();
+    }
+    if (sessions.isEmpty()) {
+        err() << "Нет записанных ответов для " << quizName << "\n";
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<ItemParameters> items = ItemCalibration::calibrate(ItemCalibration::priors(compiled), sessions);
+    const qint64 elapsedMs = timer.elapsed();
+
+    QString error;
+    if (!ItemCalibration::save(args[0], items, &error)) {
+        err() << "Не удалось сохранить " << ItemCalibration::parametersPath(args[0]) << ": " << error << "\n";
+        return 1;
+    }
+
+    int calibrated = 0;
+    for (int i = 0; i < items.size(); ++i) {
+        if (items[i].responses == 0)
+            continue;
+        out() << i + 1 << "\t" << QString::number(items[i].a, 'f', 2) << "\t"
+              << QString::number(items[i].b, 'f', 2) << "\t" << items[i].responses << "\n";
+        ++calibrated;
+    }
+    err() << "Сессий: " << sessions.size() << ", ответов: " << responses << ", вопросов: " << calibrated
+          << ", время: " << elapsedMs << " мс\n";
+    return 0;
+}
+
+// Разбор вопросов по записанным ответам: доля верных, различающая способность,
+// выбор каждого варианта и среднее время
+int printItemStats(const QStringList &args)
+{
+    if (args.size() != 1) {
+        err() << "Использование: QuizCli items <викторина>\n";
+        return 2;
+    }
+
+    QuizSource quiz;
+    if (!openQuiz(args[0], &quiz))
+        return 1;
+
+    const QString quizName = QFileInfo(args[0]).fileName();
+    const ItemStats *stats = ScoreStore::instance()->itemStats(quizName, quiz.count());
+    if (!stats) {
+        err() << "Нет записанных ответов для " << quizName << "\n";
+        return 1;
+    }
+
+    out() << "№\tответов\tверных,%\tr\tA,%\tB,%\tC,%\tD,%\tвремя,с\n";
+    for (int i = 0; i < quiz.count(); ++i) {
+        const ItemStats::Item *item = stats->item(i);
+        if (!item || item->key != quiz.question(i).correctMask)
+            continue;
+        const double discrimination = item->discrimination();
+        out() << i + 1 << "\t" << item->attempts << "\t" << QString::number(item->percentCorrect(), 'f', 1) << "\t"
+              << (std::isnan(discrimination) ? QString("—") : QString::number(discrimination, 'f', 2));
+        for (int option = 0; option < Question::kOptionCount; ++option)
+            out() << "\t" << QString::number(item->optionRate(option), 'f', 0);
+        out() << "\t" << QString::number(item->meanTimeMs() / 1000.0, 'f', 1) << "\n";
+    }
+    err() << "Записей с ответами: " << stats->records() << "\n";
+    return 0;
+}
+
+int printLeaderboard(const QStringList &args, int top)
+{
+    if (args.size() > 1) {
+        err() << "Использование: QuizCli leaderboard [--top N] [викторина]\n";
+        return 2;
+    }
+
+    const QString quizName = args.isEmpty() ? QString() : QFileInfo(args[0]).fileName();
+    const ScoreStore *store = ScoreStore::instance();
+    const LeaderboardIndex *board = store->leaderboard(quizName);
+    if (!board) {
+        err() << "Нет результатов для " << quizName << "\n";
+        return 1;
+    }
+
+    const int rows = top > 0 ? qMin(top, board->count()) : board->count();
+    for (int row = 0; row < rows; ++row) {
+        const ScoreRecord &record = store->record(board->recordAt(row));
+        out() << board->rankOf(record.score) << "\t" << record.name << "\t" << record.score;
+        if (quizName.isEmpty())
+            out() << "\t" << record.quiz;
+        out() << "\n";
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizCli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Проверка викторин, статистика, оценка ответов и таблица рекордов без графического интерфейса.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("команда", "validate | stats | grade | leaderboard | bench-grade | plan | dedupe | import | calibrate | items");
+    const QCommandLineOption saveOption("save", "grade: записать результаты в журнал scores.d/");
+    const QCommandLineOption topOption("top", "leaderboard: число строк (0 — все)", "N", "10");
+    const QCommandLineOption sheetsOption("sheets", "bench-grade: число случайных бланков", "N", "200000");
+    parser.addOption(saveOption);
+    parser.addOption(topOption);
+    const QCommandLineOption seedOption("seed", "plan: зерно сессии", "S", "0");
+    const QCommandLineOption easyOption("easy", "plan: число лёгких вопросов в выборке", "N");
+    const QCommandLineOption mediumOption("medium", "plan: число средних вопросов в выборке", "N");
+    const QCommandLineOption hardOption("hard", "plan: число сложных вопросов в выборке", "N");
+    parser.addOption(sheetsOption);
+    const QCommandLineOption similarityOption("similarity", "dedupe: порог сходства от 0 до 1", "s", "0.8");
+    parser.addOptions({seedOption, easyOption, mediumOption, hardOption, similarityOption});
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty())
+        parser.showHelp(2);
+
+    const QString command = args.takeFirst();
+    if (command == "validate")
+        return validateQuiz(args);
+    if (command == "stats")
+        return printStats(args);
+    if (command == "grade")
+        return gradeAnswers(args, parser.isSet(saveOption));
+    if (command == "leaderboard")
+        return printLeaderboard(args, parser.value(topOption).toInt());
+    if (command == "bench-grade")
+        return benchGrading(args, parser.value(sheetsOption).toInt());
+    if (command == "plan") {
+        SessionPlan::Request request = SessionPlan::Request::sequential(parser.value(seedOption).toULongLong());
+        request.sampled = parser.isSet(easyOption) || parser.isSet(mediumOption) || parser.isSet(hardOption);
+        request.counts[0] = parser.value(easyOption).toInt();
+        request.counts[1] = parser.value(mediumOption).toInt();
+        request.counts[2] = parser.value(hardOption).toInt();
+        return printPlan(args, request);
+    }
+    if (command == "import")
+        return importQuestions(args);
+    if (command == "dedupe")
+        return printDuplicates(args, parser.value(similarityOption).toDouble());
+    if (command == "calibrate")
+        return calibrateItems(args);
+    if (command == "items")
+        return printItemStats(args);
+
+    err() << "Неизвестная команда: " << command << "\n";
+    parser.showHelp(2);
+}
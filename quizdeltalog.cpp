@@ -0,0 +1,85 @@
+#include "quizdeltalog.h"
+#include "journalline.h"
+#include "quizsource.h"
+
+#include <QFile>
+
+QuizDeltaLog::QuizDeltaLog(const QString &quizFileName, QObject *parent)
+    : QObject(parent), quizFileName(quizFileName), context(new QObject)
+{
+    // Все операции с файлами выполняются по очереди в одном фоновом потоке
+    context->moveToThread(&worker);
+    worker.start();
+}
+
+QuizDeltaLog::~QuizDeltaLog()
+{
+    waitForIdle();
+    worker.quit();
+    worker.wait();
+    delete context;
+}
+
+QString QuizDeltaLog::deltaPath(const QString &quizFileName)
+{
+    return quizFileName + ".delta";
+}
+
+QHash<int, Question> QuizDeltaLog::read(const QString &quizFileName)
+{
+    QHash<int, Question> deltas;
+    QFile file(deltaPath(quizFileName));
+    if (!file.open(QIODevice::ReadOnly))
+        return deltas;
+
+    while (!file.atEnd()) {
+        QJsonObject record;
+        if (JournalLine::decode(file.readLine(), &record))
+            deltas.insert(record["index"].toInt(), Question::fromJson(record["question"].toObject()));
+    }
+    return deltas;
+}
+
+void QuizDeltaLog::record(int index, const Question &question)
+{
+    QJsonObject record;
+    record["index"] = index;
+    record["question"] = question.toJson();
+    const QByteArray line = JournalLine::encode(record);
+    const QString path = deltaPath(quizFileName);
+    ++pending;
+
+    QMetaObject::invokeMethod(context, [this, line, path]() {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append)
+            || file.write(line) != line.size()
+            || !JournalLine::syncFile(file)) {
+            emit failed("Не удалось записать правку: " + file.errorString());
+        }
+    }, Qt::QueuedConnection);
+}
+
+void QuizDeltaLog::consolidate(const PersistentQuestions &questions)
+{
+    // Снимок банка — копия указателя на корень, разворачивается он уже в
+    // фоновом потоке; правки, записанные после этого вызова, попадут в новый
+    // журнал, потому что очередь потока упорядочена
+    const QString fileName = quizFileName;
+    pending = 0;
+
+    QMetaObject::invokeMethod(context, [this, questions, fileName]() {
+        QString error;
+        if (!QuizSource::save(questions.toVector(), fileName, &error)) {
+            emit failed("Не удалось сохранить файл: " + error);
+            return;
+        }
+        QFile::remove(deltaPath(fileName));
+        emit consolidated();
+    }, Qt::QueuedConnection);
+}
+
+void QuizDeltaLog::waitForIdle()
+{
+    if (worker.isRunning())
+        QMetaObject::invokeMethod(context, []() {}, Qt::BlockingQueuedConnection);
+}
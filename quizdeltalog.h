@@ -0,0 +1,45 @@
+#ifndef QUIZDELTALOG_H
+#define QUIZDELTALOG_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QThread>
+
+#include "question.h"
+#include "persistentquestions.h"
+
+// Журнал правок викторины "<файл>.delta": каждая сохранённая правка
+// дописывается одной строкой в фоновом потоке, а время от времени весь банк
+// атомарно перезаписывается через QSaveFile и журнал очищается. После сбоя
+// правки из журнала применяются поверх файла при следующей загрузке.
+class QuizDeltaLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QuizDeltaLog(const QString &quizFileName, QObject *parent = nullptr);
+    ~QuizDeltaLog();
+
+    static QString deltaPath(const QString &quizFileName);
+    static QHash<int, Question> read(const QString &quizFileName);
+
+    void record(int index, const Question &question);
+    void consolidate(const PersistentQuestions &questions);
+    void waitForIdle();
+
+    int pendingCount() const { return pending; }
+
+signals:
+    void failed(const QString &message);
+    void consolidated();
+
+private:
+    QString quizFileName;
+    QThread worker;
+    QObject *context;
+    int pending = 0;
+};
+
+#endif // QUIZDELTALOG_H
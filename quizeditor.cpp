@@ -1,4 +1,7 @@
 #include "quizeditor.h"
+#include "quizsource.h"
+#include "questionmodel.h"
+#include "quizimporter.h"
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -42,98 +45,53 @@ QuizEditor::QuizEditor(QWidget *parent)
 
     addButton = new QPushButton("Добавить вопрос", this);
     saveButton = new QPushButton("Сохранить тест", this);
+    importButton = new QPushButton("Импорт из CSV, GIFT или Markdown…", this);
     layout->addWidget(addButton);
     layout->addWidget(saveButton);
+    layout->addWidget(importButton);
 
-    questionList = new QListWidget(this);
+    questionModel = new QuestionModel(QuestionModel::Detailed, this);
+    questionList = new QListView(this);
+    questionList->setModel(questionModel);
+    questionList->setUniformItemSizes(true);
     layout->addWidget(questionList);
 
     connect(addButton, &QPushButton::clicked, this, &QuizEditor::addQuestion);
     connect(saveButton, &QPushButton::clicked, this, &QuizEditor::saveQuiz);
-
-    this->setStyleSheet(R"(
-        QWidget {
-            background-color: #ffe4f0;
-            font-family: "Segoe UI", sans-serif;
-        }
-        QLineEdit, QListWidget {
-            background: #fff0f8;
-            border: 1px solid #ffaad4;
-            border-radius: 6px;
-            padding: 4px;
-        }
-        QRadioButton {
-            color: #d81b60;
-        }
-        QPushButton {
-            background-color: #ffaad4;
-            border: 2px solid white;
-            border-radius: 10px;
-            color: white;
-            font-weight: bold;
-            padding: 6px;
-        }
-        QPushButton:hover {
-            background-color: #ff8fb6;
-        }
-    )");
+    connect(importButton, &QPushButton::clicked, this, &QuizEditor::importQuestions);
 }
 
 void QuizEditor::addQuestion() {
-    QString question = questionEdit->text();
+    Question question;
+    question.text = questionEdit->text();
 
-    QStringList options;
     for (int i = 0; i < 4; ++i) {
-        options << optionEdits[i]->text();
+        question.options[i] = optionEdits[i]->text();
+        if (checkBoxes[i]->isChecked())
+            question.correctMask |= 1u << i;
     }
 
-    QJsonArray correctIndexes;
-    for (int i = 0; i < 4; ++i) {
-        if (checkBoxes[i]->isChecked()) {
-            correctIndexes.append(i);
-        }
-    }
-
-    if (question.isEmpty() || options.contains("") || correctIndexes.isEmpty()) {
+    if (!question.isComplete()) {
         QMessageBox::warning(this, "Ошибка", "Заполните все поля и выберите хотя бы один правильный ответ");
         return;
     }
 
-    QJsonObject questionData;
-    int difficulty = difficultyBox->currentData().toInt();
-    questionData["difficulty"] = difficulty;
-    questionData["question"] = question;
-    questionData["correct"] = correctIndexes;
-
-    QJsonArray optionsArray;
-    for (const QString& option : options) {
-        optionsArray.append(option);
-    }
-    questionData["options"] = optionsArray;
-
-    QString difficultyStr;
-    switch (difficulty) {
-    case 1: difficultyStr = "Лёгкий"; break;
-    case 2: difficultyStr = "Средний"; break;
-    case 3: difficultyStr = "Сложный"; break;
-    default: difficultyStr = "Неизвестно";
-    }
-
-    QStringList correctOptions;
-    for (auto val : correctIndexes) {
-        int idx = val.toInt();
-        if (idx >= 0 && idx < options.size()) {
-            correctOptions << options[idx];
-        }
+    // Банки собираются из вопросов разных авторов, поэтому перед добавлением
+    // ищем уже введённые вопросы с почти тем же текстом
+    const QVector<DuplicateIndex::Match> similar = duplicates.findSimilar(question, 0.8);
+    if (!similar.isEmpty()) {
+        const DuplicateIndex::Match &match = similar.first();
+        const QString message = QString("Похожий вопрос уже есть (№%1, сходство %2%):\n%3\n\nВсё равно добавить?")
+                                    .arg(match.id + 1)
+                                    .arg(qRound(match.similarity * 100))
+                                    .arg(questionModel->question(match.id).text);
+        if (QMessageBox::question(this, "Возможный повтор", message) != QMessageBox::Yes)
+            return;
     }
 
-    QString display = QString("Вопрос: %1\nПравильные ответы: %2\nСложность: %3")
-                          .arg(question)
-                          .arg(correctOptions.join(", "))
-                          .arg(difficultyStr);
-    QListWidgetItem* item = new QListWidgetItem(display);
-    item->setData(Qt::UserRole, questionData);
-    questionList->addItem(item);
+    question.difficulty = static_cast<quint8>(difficultyBox->currentData().toInt());
+    duplicates.add(questionModel->count(), question);
+    questionModel->append(question);
 
     questionEdit->clear();
     for (int i = 0; i < 4; ++i) {
@@ -144,30 +102,70 @@ void QuizEditor::addQuestion() {
 
 
 void QuizEditor::saveQuiz() {
-    if (questionList->count() == 0) {
+    if (questionModel->count() == 0) {
         QMessageBox::warning(this, "Ошибка", "Нет вопросов для сохранения");
         return;
     }
 
-    QJsonArray quizArray;
-    for (int i = 0; i < questionList->count(); ++i) {
-        quizArray.append(questionList->item(i)->data(Qt::UserRole).toJsonObject());
-    }
-
-    QString fileName = QFileDialog::getSaveFileName(this, "Сохранить викторину", "", "JSON Files (*.json)");
+    QString fileName = QFileDialog::getSaveFileName(this, "Сохранить викторину", "",
+                                                    "JSON Files (*.json);;Скомпилированные викторины (*.quizbin)");
     if (fileName.isEmpty()) return;
 
-    QFile file(fileName);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(quizArray).toJson());
-        file.close();
+    if (QuizSource::save(questionModel->questions().toVector(), fileName)) {
         QMessageBox::information(this, "Успех", "Викторина сохранена");
     } else {
         QMessageBox::critical(this, "Ошибка", "Не удалось сохранить файл");
     }
 }
 
-QListWidget* QuizEditor::getQuestionList()
+void QuizEditor::importQuestions() {
+    if (importer)
+        return;
+
+    const QString fileName = QFileDialog::getOpenFileName(this, "Импорт вопросов", "", QuizImporter::fileFilter());
+    if (fileName.isEmpty()) return;
+
+    // Вопросы приходят пачками из рабочего потока и сразу попадают в список
+    importErrors.clear();
+    importer = new QuizImporter(fileName, this);
+    importButton->setEnabled(false);
+
+    connect(importer, &QuizImporter::questionsImported, this, [this](const QVector<Question> &batch) {
+        const int first = questionModel->count();
+        for (int i = 0; i < batch.size(); ++i)
+            duplicates.add(first + i, batch[i]);
+        questionModel->append(batch);
+    });
+    connect(importer, &QuizImporter::rowsRejected, this, [this](const QStringList &errors) {
+        importErrors += errors;
+    });
+    connect(importer, &QuizImporter::progress, this, [this](qint64 bytesRead, qint64 totalBytes) {
+        importButton->setText(QString("Импорт… %1%").arg(totalBytes > 0 ? bytesRead * 100 / totalBytes : 100));
+    });
+    connect(importer, &QuizImporter::finished, this, [this](int imported, int rejected, qint64 elapsedMs, bool) {
+        importer->deleteLater();
+        importer = nullptr;
+        importButton->setText("Импорт из CSV, GIFT или Markdown…");
+        importButton->setEnabled(true);
+
+        const qint64 rowsPerSecond = qint64(imported + rejected) * 1000 / qMax<qint64>(1, elapsedMs);
+        QMessageBox box(rejected == 0 ? QMessageBox::Information : QMessageBox::Warning, "Импорт",
+                        QString("Импортировано вопросов: %1\nОтклонено записей: %2\nВремя: %3 мс (%4 записей/с)")
+                            .arg(imported).arg(rejected).arg(elapsedMs).arg(rowsPerSecond),
+                        QMessageBox::Ok, this);
+        if (!importErrors.isEmpty())
+            box.setDetailedText(importErrors.join('\n'));
+        box.exec();
+    });
+    importer->start();
+}
+
+QListView* QuizEditor::getQuestionList()
 {
     return questionList;
 }
+
+QuestionModel* QuizEditor::getQuestionModel()
+{
+    return questionModel;
+}
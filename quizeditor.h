@@ -5,32 +5,45 @@
 #include <QLineEdit>
 #include <QRadioButton>
 #include <QPushButton>
-#include <QListWidget>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QButtonGroup>
 #include <QComboBox>
 #include <QCheckBox>
+#include <QStringList>
+
+#include "duplicateindex.h"
+
+class QuestionModel;
+class QuizImporter;
 
 class QuizEditor : public QWidget {
     Q_OBJECT
 
 public:
     QuizEditor(QWidget *parent = nullptr);
-    QListWidget* getQuestionList();
+    QListView* getQuestionList();
+    QuestionModel* getQuestionModel();
 
 private slots:
     void addQuestion();
     void saveQuiz();
+    void importQuestions();
 
 private:
     QLineEdit *questionEdit;
     QLineEdit *optionEdits[4];
     QCheckBox *checkBoxes[4];
 
-    QListWidget *questionList;
+    QListView *questionList;
+    QuestionModel *questionModel;
     QPushButton *addButton;
     QPushButton *saveButton;
+    QPushButton *importButton;
     QComboBox *difficultyBox;
+    DuplicateIndex duplicates;
+    QuizImporter *importer = nullptr;
+    QStringList importErrors;
 
 };
 
@@ -0,0 +1,139 @@
+#include "quizgenerator.h"
+#include "journalline.h"
+#include "scorejournal.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <functional>
+
+// QuizGen — синтетические банки вопросов и истории результатов для
+// нагрузочных прогонов. Вывод пишется потоково кусками по ~1 МБ, поэтому
+// файлы любого размера создаются в постоянном объёме памяти.
+
+namespace {
+
+const int kFlushBytes = 1 << 20;
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+bool flushTo(QFile &file, QByteArray &buffer)
+{
+    if (file.write(buffer) != buffer.size()) {
+        err() << "Ошибка записи " << file.fileName() << ": " << file.errorString() << "\n";
+        return false;
+    }
+    buffer.clear();
+    return true;
+}
+
+// Массив JSON в том же виде, в каком его сохраняет редактор, по объекту на строку
+bool writeJsonArray(const QString &fileName, qint64 count, const std::function<QJsonObject()> &next)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err() << "Не удалось создать " << fileName << ": " << file.errorString() << "\n";
+        return false;
+    }
+
+    QByteArray buffer = "[\n";
+    for (qint64 i = 0; i < count; ++i) {
+        buffer += QJsonDocument(next()).toJson(QJsonDocument::Compact);
+        buffer += i + 1 < count ? ",\n" : "\n";
+        if (buffer.size() >= kFlushBytes && !flushTo(file, buffer))
+            return false;
+    }
+    buffer += "]\n";
+    return flushTo(file, buffer);
+}
+
+// Сразу в журнал scores.d/, минуя перенос scores.json
+bool writeJournal(const QString &dirPath, qint64 count, QuizGenerator &generator)
+{
+    ScoreJournal journal(dirPath);
+    QByteArray lines;
+    for (qint64 i = 0; i < count; ++i) {
+        lines += JournalLine::encode(generator.nextScore().toJson());
+        if (lines.size() >= kFlushBytes || i + 1 == count) {
+            if (!journal.appendBatch(lines)) {
+                err() << "Ошибка записи в журнал " << dirPath << "\n";
+                return false;
+            }
+            lines.clear();
+        }
+    }
+    return true;
+}
+
+bool parseMix(const QString &text, int mix[3])
+{
+    const QStringList parts = text.split(',');
+    if (parts.size() != 3)
+        return false;
+    for (int i = 0; i < 3; ++i) {
+        bool ok = false;
+        mix[i] = parts[i].trimmed().toInt(&ok);
+        if (!ok || mix[i] < 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizGen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Генерация банков вопросов и истории результатов.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("вид", "bank | scores");
+    parser.addPositionalArgument("выход", "файл .json (для scores с --journal — каталог журнала)");
+    const QCommandLineOption countOption("count", "Число вопросов или результатов", "N", "1000");
+    const QCommandLineOption seedOption("seed", "Зерно генератора", "S", "1");
+    const QCommandLineOption mixOption("mix", "bank: доли лёгких, средних и сложных, %", "a,b,c", "50,35,15");
+    const QCommandLineOption multiOption("multi", "bank: доля вопросов с несколькими ответами, %", "p", "20");
+    const QCommandLineOption quizzesOption("quizzes", "scores: число разных викторин", "N", "10");
+    const QCommandLineOption usersOption("users", "scores: число разных участников", "N", "1000");
+    const QCommandLineOption journalOption("journal", "scores: писать в каталог журнала вместо scores.json");
+    parser.addOptions({countOption, seedOption, mixOption, multiOption, quizzesOption, usersOption, journalOption});
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2)
+        parser.showHelp(2);
+
+    QuizGenerator::Options options;
+    options.seed = parser.value(seedOption).toULongLong();
+    options.multiCorrectPercent = parser.value(multiOption).toInt();
+    options.quizCount = parser.value(quizzesOption).toInt();
+    options.userCount = parser.value(usersOption).toInt();
+    if (!parseMix(parser.value(mixOption), options.difficultyMix)) {
+        err() << "Неверный формат --mix, ожидается три числа через запятую\n";
+        return 2;
+    }
+
+    const qint64 count = parser.value(countOption).toLongLong();
+    QuizGenerator generator(options);
+
+    bool ok = false;
+    if (args[0] == "bank") {
+        ok = writeJsonArray(args[1], count, [&generator]() { return generator.nextQuestion().toJson(); });
+    } else if (args[0] == "scores") {
+        ok = parser.isSet(journalOption)
+                 ? writeJournal(args[1], count, generator)
+                 : writeJsonArray(args[1], count, [&generator]() { return generator.nextScore().toJson(); });
+    } else {
+        err() << "Неизвестный вид: " << args[0] << "\n";
+        parser.showHelp(2);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "quizgenerator.h"
+
+#include <QtAlgorithms>
+
+namespace {
+
+const char *const kWords[] = {
+    "какой", "город", "является", "столицей", "страны", "река", "впадает", "в", "море",
+    "сколько", "планет", "солнечной", "системы", "кто", "написал", "роман", "поэму",
+    "год", "основания", "государства", "химический", "элемент", "обозначается", "символом",
+    "самая", "высокая", "гора", "континента", "автор", "картины", "музыкального",
+    "произведения", "формула", "воды", "скорость", "света", "вакууме", "равна", "чему",
+    "корень", "уравнения", "площадь", "треугольника", "язык", "программирования",
+    "создал", "изобрёл", "открыл", "закон", "теорема", "доказал", "учёный", "век",
+    "битва", "произошла", "где", "когда", "почему", "животное", "растение", "орган",
+    "клетки", "единица", "измерения", "силы", "тока", "мощности", "энергии",
+};
+const int kWordCount = int(sizeof(kWords) / sizeof(kWords[0]));
+
+// Распределение длины в словах: {от, до, доля %}. Это принятые по умолчанию
+// допущения, а не замер реальных банков: большинство вопросов короткие, но
+// длинный хвост оставлен, чтобы прогоны задевали и длинные строки.
+const int kQuestionLengths[][3] = {
+    {3, 5, 10}, {6, 8, 25}, {9, 12, 30}, {13, 18, 20}, {19, 30, 10}, {31, 60, 5},
+};
+const int kOptionLengths[][3] = {
+    {1, 1, 35}, {2, 3, 40}, {4, 6, 20}, {7, 12, 5},
+};
+
+} // namespace
+
+QuizGenerator::QuizGenerator(const Options &options)
+    : options(options), rng(options.seed)
+{
+    for (int i = 0; i < kWordCount; ++i)
+        vocabulary << QString::fromUtf8(kWords[i]);
+}
+
+QString QuizGenerator::quizName(int index)
+{
+    return QString("generated-%1.json").arg(index + 1);
+}
+
+quint64 QuizGenerator::bounded(quint64 bound)
+{
+    const quint64 threshold = (0 - bound) % bound;
+    quint64 value;
+    do {
+        value = rng();
+    } while (value < threshold);
+    return value % bound;
+}
+
+int QuizGenerator::pickLength(const int (*buckets)[3], int bucketCount)
+{
+    int roll = int(bounded(100));
+    for (int b = 0; b < bucketCount; ++b) {
+        if (roll < buckets[b][2] || b == bucketCount - 1)
+            return buckets[b][0] + int(bounded(quint64(buckets[b][1] - buckets[b][0] + 1)));
+        roll -= buckets[b][2];
+    }
+    return buckets[0][0];
+}
+
+QString QuizGenerator::words(int count)
+{
+    QString text;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0)
+            text += ' ';
+        text += vocabulary[int(bounded(quint64(vocabulary.size())))];
+    }
+    return text;
+}
+
+void QuizGenerator::addCorrectOption(Question &q)
+{
+    // Выбирается k-й из ещё не отмеченных вариантов, чтобы доля вопросов с
+    // несколькими правильными ответами совпадала с заданной
+    int k = int(bounded(quint64(Question::kOptionCount - qPopulationCount(q.correctMask))));
+    for (int option = 0; option < Question::kOptionCount; ++option) {
+        if (q.isCorrect(option))
+            continue;
+        if (k-- == 0) {
+            q.correctMask |= static_cast<quint8>(1u << option);
+            return;
+        }
+    }
+}
+
+Question QuizGenerator::nextQuestion()
+{
+    Question q;
+    // Номер в тексте делает вопросы различимыми, как в настоящих банках
+    q.text = QString("%1. %2?").arg(++questionNumber)
+                 .arg(words(pickLength(kQuestionLengths, int(sizeof(kQuestionLengths) / sizeof(kQuestionLengths[0])))));
+    for (QString &option : q.options)
+        option = words(pickLength(kOptionLengths, int(sizeof(kOptionLengths) / sizeof(kOptionLengths[0]))));
+
+    q.correctMask = static_cast<quint8>(1u << bounded(Question::kOptionCount));
+    if (int(bounded(100)) < options.multiCorrectPercent) {
+        // Второй (а иногда и третий) правильный вариант
+        addCorrectOption(q);
+        if (bounded(4) == 0)
+            addCorrectOption(q);
+    }
+
+    const int mixTotal = qMax(1, options.difficultyMix[0] + options.difficultyMix[1] + options.difficultyMix[2]);
+    int roll = int(bounded(quint64(mixTotal)));
+    q.difficulty = 3;
+    for (int level = 0; level < 3; ++level) {
+        if (roll < options.difficultyMix[level]) {
+            q.difficulty = static_cast<quint8>(level + 1);
+            break;
+        }
+        roll -= options.difficultyMix[level];
+    }
+    return q;
+}
+
+ScoreRecord QuizGenerator::nextScore()
+{
+    ScoreRecord record;
+    // Активность пользователей неравномерна: минимум из двух бросков смещает
+    // выбор к началу списка, и часть участников проходит викторины чаще других
+    const quint64 users = quint64(qMax(1, options.userCount));
+    record.name = QString("Участник %1").arg(qMin(bounded(users), bounded(users)) + 1);
+    record.quiz = quizName(int(bounded(quint64(qMax(1, options.quizCount)))));
+    // Сумма двух бросков даёт колоколообразное распределение баллов
+    record.score = int(bounded(51) + bounded(51));
+    return record;
+}
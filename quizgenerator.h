@@ -0,0 +1,48 @@
+#ifndef QUIZGENERATOR_H
+#define QUIZGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <random>
+
+#include "question.h"
+#include "scorestore.h"
+
+// Детерминированный генератор синтетических вопросов и результатов для
+// нагрузочных прогонов. Одно и то же зерно и одни и те же параметры дают
+// одинаковый поток на любой платформе: используется mt19937_64 и только
+// целочисленные преобразования (никаких std::*_distribution).
+class QuizGenerator
+{
+public:
+    struct Options
+    {
+        quint64 seed = 1;
+        // Доли лёгких, средних и сложных вопросов в процентах
+        int difficultyMix[3] = {50, 35, 15};
+        // Доля вопросов с несколькими правильными ответами, в процентах
+        int multiCorrectPercent = 20;
+        int quizCount = 10;
+        int userCount = 1000;
+    };
+
+    explicit QuizGenerator(const Options &options);
+
+    Question nextQuestion();
+    ScoreRecord nextScore();
+
+    static QString quizName(int index);
+
+private:
+    quint64 bounded(quint64 bound);
+    int pickLength(const int (*buckets)[3], int bucketCount);
+    QString words(int count);
+    void addCorrectOption(Question &q);
+
+    Options options;
+    std::mt19937_64 rng;
+    QStringList vocabulary;
+    int questionNumber = 0;
+};
+
+#endif // QUIZGENERATOR_H
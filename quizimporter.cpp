@@ -0,0 +1,553 @@
+#include "quizimporter.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <deque>
+#include <memory>
+
+namespace {
+
+const qint64 kChunkSize = 1 << 20;
+
+// Кусок файла в пуле: рабочий поток ждёт done, прежде чем брать результат
+struct Job
+{
+    QByteArray data;
+    qint64 firstLine = 1;
+    bool first = false;
+    QuizImporter::Chunk result;
+    QSemaphore done;
+};
+
+QString rowError(qint64 line, const QString &message)
+{
+    return QString("Строка %1: %2").arg(line).arg(message);
+}
+
+// Те же требования, что у QuizEditor::addQuestion и QuizCli validate
+QString validate(const Question &q, int optionCount)
+{
+    if (optionCount != Question::kOptionCount)
+        return QString("ожидалось 4 варианта ответа, найдено %1").arg(optionCount);
+    if (q.text.isEmpty())
+        return "пустой текст вопроса";
+    for (const QString &option : q.options) {
+        if (option.isEmpty())
+            return "пустой вариант ответа";
+    }
+    if (q.correctMask == 0)
+        return "не отмечен правильный ответ";
+    if (q.difficulty < 1 || q.difficulty > 3)
+        return QString("недопустимая сложность %1").arg(int(q.difficulty));
+    return QString();
+}
+
+bool parseDifficulty(const QString &text, quint8 *difficulty)
+{
+    const QString value = text.trimmed();
+    if (value.isEmpty())
+        return true;
+    bool ok = false;
+    const int level = value.toInt(&ok);
+    if (!ok || level < 1 || level > 3)
+        return false;
+    *difficulty = quint8(level);
+    return true;
+}
+
+// "1;3", "2 4", "A,C", "Б" — номера 1-4, латинские A-D или русские А-Г
+bool parseCorrect(const QString &text, quint8 *mask)
+{
+    *mask = 0;
+    for (const QChar ch : text) {
+        const QChar up = ch.toUpper();
+        int index = -1;
+        if (ch >= QChar('1') && ch <= QChar('4'))
+            index = ch.unicode() - '1';
+        else if (up >= QChar('A') && up <= QChar('D'))
+            index = up.unicode() - 'A';
+        else if (up >= QChar(0x0410) && up <= QChar(0x0413))
+            index = up.unicode() - 0x0410;
+
+        if (index >= 0)
+            *mask |= 1u << index;
+        else if (ch.isLetterOrNumber())
+            return false;
+    }
+    return *mask != 0;
+}
+
+void addCsvRecord(const QList<QByteArray> &fields, qint64 line, bool mayBeHeader, QuizImporter::Chunk &chunk)
+{
+    if (fields.size() < 6) {
+        chunk.errors << rowError(line, QString("ожидалось не меньше 6 полей, найдено %1").arg(fields.size()));
+        return;
+    }
+
+    Question q;
+    q.text = QString::fromUtf8(fields[0]).trimmed();
+    for (int i = 0; i < Question::kOptionCount; ++i)
+        q.options[i] = QString::fromUtf8(fields[i + 1]).trimmed();
+
+    const QString correct = QString::fromUtf8(fields[5]);
+    if (!parseCorrect(correct, &q.correctMask)) {
+        if (!mayBeHeader)
+            chunk.errors << rowError(line, QString("не удалось разобрать правильные ответы «%1»").arg(correct.trimmed()));
+        return;
+    }
+    if (fields.size() > 6 && !parseDifficulty(QString::fromUtf8(fields[6]), &q.difficulty)) {
+        chunk.errors << rowError(line, QString("недопустимая сложность «%1»").arg(QString::fromUtf8(fields[6]).trimmed()));
+        return;
+    }
+
+    const QString error = validate(q, Question::kOptionCount);
+    if (error.isEmpty())
+        chunk.questions.append(q);
+    else
+        chunk.errors << rowError(line, error);
+}
+
+// Поля в кавычках по RFC 4180: разделители и переводы строк внутри, "" — кавычка
+QuizImporter::Chunk parseCsv(const QByteArray &data, qint64 firstLine, char delimiter, bool mayHaveHeader)
+{
+    QuizImporter::Chunk chunk;
+    QList<QByteArray> fields;
+    QByteArray field;
+    bool inQuotes = false;
+    bool firstRecord = true;
+    qint64 line = firstLine;
+    qint64 recordLine = firstLine;
+
+    auto endRecord = [&]() {
+        fields.append(field);
+        field.clear();
+        if (fields.size() > 1 || !fields[0].trimmed().isEmpty()) {
+            addCsvRecord(fields, recordLine, firstRecord && mayHaveHeader, chunk);
+            firstRecord = false;
+        }
+        fields.clear();
+        recordLine = line;
+    };
+
+    for (int i = 0; i < data.size(); ++i) {
+        const char c = data.at(i);
+        if (inQuotes) {
+            if (c != '"') {
+                if (c == '\n')
+                    ++line;
+                field += c;
+            } else if (i + 1 < data.size() && data.at(i + 1) == '"') {
+                field += '"';
+                ++i;
+            } else {
+                inQuotes = false;
+            }
+            continue;
+        }
+
+        if (c == '"') {
+            inQuotes = true;
+        } else if (c == delimiter) {
+            fields.append(field);
+            field.clear();
+        } else if (c == '\n') {
+            ++line;
+            endRecord();
+        } else if (c != '\r') {
+            field += c;
+        }
+    }
+    if (!field.isEmpty() || !fields.isEmpty())
+        endRecord();
+    return chunk;
+}
+
+// Экранирование GIFT: \= \~ \# \{ \} \: и \n
+QString giftUnescape(const QString &text)
+{
+    QString result;
+    result.reserve(text.size());
+    for (int i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            ++i;
+            result += text[i] == 'n' ? QChar('\n') : text[i];
+        } else {
+            result += text[i];
+        }
+    }
+    return result.simplified();
+}
+
+int findUnescaped(const QString &text, QChar ch, int from = 0)
+{
+    for (int i = from; i < text.size(); ++i) {
+        if (text[i] == '\\')
+            ++i;
+        else if (text[i] == ch)
+            return i;
+    }
+    return -1;
+}
+
+void addGiftRecord(const QString &record, qint64 line, QuizImporter::Chunk &chunk)
+{
+    const int open = findUnescaped(record, '{');
+    const int close = open < 0 ? -1 : findUnescaped(record, '}', open + 1);
+    if (close < 0) {
+        chunk.errors << rowError(line, "нет блока ответов {…}");
+        return;
+    }
+
+    Question q;
+    QString stem = (record.left(open) + ' ' + record.mid(close + 1)).trimmed();
+    if (stem.startsWith("::")) {
+        const int titleEnd = stem.indexOf("::", 2);
+        if (titleEnd >= 0)
+            stem = stem.mid(titleEnd + 2);
+    }
+    q.text = giftUnescape(stem);
+
+    // Ответы начинаются с неэкранированных = (верный) или ~ (неверный или с весом)
+    const QString body = record.mid(open + 1, close - open - 1);
+    QStringList answers;
+    QVector<QChar> kinds;
+    int start = -1;
+    for (int i = 0; i <= body.size(); ++i) {
+        if (i + 1 < body.size() && body[i] == '\\') {
+            ++i;
+            continue;
+        }
+        if (i == body.size() || body[i] == '=' || body[i] == '~') {
+            if (start >= 0)
+                answers << body.mid(start + 1, i - start - 1);
+            if (i < body.size()) {
+                kinds << body[i];
+                start = i;
+            }
+        }
+    }
+
+    int options = 0;
+    for (int i = 0; i < answers.size(); ++i) {
+        QString answer = answers[i];
+        const int feedback = findUnescaped(answer, '#');
+        if (feedback >= 0)
+            answer.truncate(feedback);
+        answer = answer.trimmed();
+
+        bool correct = kinds[i] == '=';
+        if (answer.startsWith('%')) {
+            const int weightEnd = answer.indexOf('%', 1);
+            if (weightEnd > 0) {
+                correct = answer.mid(1, weightEnd - 1).toDouble() > 0;
+                answer = answer.mid(weightEnd + 1);
+            }
+        }
+        if (options < Question::kOptionCount) {
+            q.options[options] = giftUnescape(answer);
+            if (correct)
+                q.correctMask |= 1u << options;
+        }
+        ++options;
+    }
+
+    const QString error = validate(q, options);
+    if (error.isEmpty())
+        chunk.questions.append(q);
+    else
+        chunk.errors << rowError(line, error);
+}
+
+// Записи GIFT разделены пустыми строками, строки // — комментарии
+QuizImporter::Chunk parseGift(const QByteArray &data, qint64 firstLine)
+{
+    QuizImporter::Chunk chunk;
+    const QStringList lines = QString::fromUtf8(data).split('\n');
+    QString record;
+    qint64 recordLine = firstLine;
+
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString trimmed = lines[i].trimmed();
+        if (trimmed.isEmpty()) {
+            if (!record.isEmpty())
+                addGiftRecord(record, recordLine, chunk);
+            record.clear();
+            continue;
+        }
+        if (trimmed.startsWith("//") || trimmed.startsWith("$CATEGORY"))
+            continue;
+        if (record.isEmpty())
+            recordLine = firstLine + i;
+        record += trimmed;
+        record += '\n';
+    }
+    if (!record.isEmpty())
+        addGiftRecord(record, recordLine, chunk);
+    return chunk;
+}
+
+QuizImporter::Chunk parseMarkdown(const QByteArray &data, qint64 firstLine)
+{
+    QuizImporter::Chunk chunk;
+    const QStringList lines = QString::fromUtf8(data).split('\n');
+    Question q;
+    int options = 0;
+    bool open = false;
+    qint64 recordLine = firstLine;
+    QString error;
+
+    auto finish = [&]() {
+        if (!open)
+            return;
+        if (error.isEmpty())
+            error = validate(q, options);
+        if (error.isEmpty())
+            chunk.questions.append(q);
+        else
+            chunk.errors << rowError(recordLine, error);
+    };
+
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString line = lines[i].trimmed();
+        if (line.startsWith('#')) {
+            finish();
+            open = true;
+            recordLine = firstLine + i;
+            q = Question();
+            int level = 0;
+            while (level < line.size() && line[level] == '#')
+                ++level;
+            q.text = line.mid(level).trimmed();
+            options = 0;
+            error.clear();
+            continue;
+        }
+        if (!open || line.isEmpty())
+            continue;
+
+        // "- [x] вариант" или "* [ ] вариант"
+        if ((line.startsWith("- [") || line.startsWith("* [")) && line.size() >= 5 && line[4] == ']') {
+            if (options < Question::kOptionCount) {
+                q.options[options] = line.mid(5).trimmed();
+                if (line[3] == 'x' || line[3] == 'X')
+                    q.correctMask |= 1u << options;
+            }
+            ++options;
+            continue;
+        }
+
+        const int colon = line.indexOf(':');
+        const QString key = colon > 0 ? line.left(colon).trimmed() : QString();
+        if (key.compare("Сложность", Qt::CaseInsensitive) == 0 || key.compare("Difficulty", Qt::CaseInsensitive) == 0) {
+            if (!parseDifficulty(line.mid(colon + 1), &q.difficulty) && error.isEmpty())
+                error = QString("недопустимая сложность «%1»").arg(line.mid(colon + 1).trimmed());
+        } else if (options == 0) {
+            q.text += ' ' + line;
+        } else if (error.isEmpty()) {
+            error = QString("лишний текст после вариантов (строка %1)").arg(firstLine + i);
+        }
+    }
+    finish();
+    return chunk;
+}
+
+// Конец последней целой записи в буфере; 0 — целой записи ещё нет
+int recordBoundary(QuizImporter::Format format, const QByteArray &data)
+{
+    if (format == QuizImporter::Csv) {
+        // Буфер всегда начинается вне кавычек, поэтому чётность кавычек точна
+        bool inQuotes = false;
+        int boundary = 0;
+        for (int i = 0; i < data.size(); ++i) {
+            if (data.at(i) == '"')
+                inQuotes = !inQuotes;
+            else if (data.at(i) == '\n' && !inQuotes)
+                boundary = i + 1;
+        }
+        return boundary;
+    }
+    if (format == QuizImporter::Gift) {
+        const int lf = int(data.lastIndexOf("\n\n"));
+        const int crlf = int(data.lastIndexOf("\n\r\n"));
+        return qMax(lf < 0 ? 0 : lf + 2, crlf < 0 ? 0 : crlf + 3);
+    }
+
+    const int heading = int(data.lastIndexOf("\n#"));
+    return heading < 0 ? 0 : heading + 1;
+}
+
+char detectDelimiter(const QByteArray &firstLine)
+{
+    const char candidates[] = {',', ';', '\t'};
+    char best = ',';
+    int bestCount = 0;
+    for (char candidate : candidates) {
+        const int count = int(firstLine.count(candidate));
+        if (count > bestCount) {
+            best = candidate;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+QuizImporter::QuizImporter(const QString &fileName, QObject *parent)
+    : QObject(parent), fileName(fileName)
+{
+    qRegisterMetaType<QVector<Question>>("QVector<Question>");
+}
+
+QuizImporter::~QuizImporter()
+{
+    cancel();
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+QuizImporter::Format QuizImporter::formatOf(const QString &fileName)
+{
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "csv" || suffix == "tsv")
+        return Csv;
+    if (suffix == "gift" || suffix == "txt")
+        return Gift;
+    if (suffix == "md" || suffix == "markdown")
+        return Markdown;
+    return Unknown;
+}
+
+QString QuizImporter::fileFilter()
+{
+    return "Вопросы для импорта (*.csv *.tsv *.gift *.txt *.md *.markdown)";
+}
+
+QuizImporter::Chunk QuizImporter::parse(Format format, const QByteArray &data, qint64 firstLine,
+                                        char delimiter, bool mayHaveHeader)
+{
+    switch (format) {
+    case Csv:
+        return parseCsv(data, firstLine, delimiter, mayHaveHeader);
+    case Gift:
+        return parseGift(data, firstLine);
+    case Markdown:
+        return parseMarkdown(data, firstLine);
+    case Unknown:
+        break;
+    }
+    return Chunk();
+}
+
+void QuizImporter::start()
+{
+    if (thread)
+        return;
+
+    thread = QThread::create([this]() { run(); });
+    thread->start();
+}
+
+void QuizImporter::cancel()
+{
+    cancelled.storeRelaxed(1);
+}
+
+void QuizImporter::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const Format format = formatOf(fileName);
+    QFile file(fileName);
+    if (format == Unknown || !file.open(QIODevice::ReadOnly)) {
+        emit rowsRejected({format == Unknown ? QString("Неизвестный формат файла %1").arg(fileName)
+                                             : QString("Не удалось открыть %1: %2").arg(fileName, file.errorString())});
+        emit finished(0, 0, timer.elapsed(), false);
+        return;
+    }
+
+    const qint64 total = file.size();
+    const QByteArray head = file.peek(64 * 1024);
+    const char delimiter = detectDelimiter(head.left(head.indexOf('\n')));
+
+    // Не больше двух кусков на ядро в работе, чтобы память не росла с размером файла
+    const int window = qMax(2, QThread::idealThreadCount() * 2);
+    std::deque<std::unique_ptr<Job>> jobs;
+    qint64 nextLine = 1;
+    bool firstJob = true;
+    int imported = 0;
+    int rejected = 0;
+
+    auto collect = [&](bool report) {
+        std::unique_ptr<Job> job = std::move(jobs.front());
+        jobs.pop_front();
+        job->done.acquire();
+        if (!report)
+            return;
+        imported += job->result.questions.size();
+        rejected += job->result.errors.size();
+        if (!job->result.questions.isEmpty())
+            emit questionsImported(job->result.questions);
+        if (!job->result.errors.isEmpty())
+            emit rowsRejected(job->result.errors);
+    };
+
+    auto submit = [&](const QByteArray &data) {
+        auto job = std::make_unique<Job>();
+        job->data = data;
+        job->firstLine = nextLine;
+        job->first = firstJob;
+        firstJob = false;
+        nextLine += data.count('\n');
+
+        Job *raw = job.get();
+        QThreadPool::globalInstance()->start([raw, format, delimiter]() {
+            raw->result = parse(format, raw->data, raw->firstLine, delimiter, raw->first);
+            raw->done.release();
+        });
+        jobs.push_back(std::move(job));
+        if (int(jobs.size()) >= window)
+            collect(true);
+    };
+
+    QByteArray carry;
+    bool atStart = true;
+    while (true) {
+        if (cancelled.loadRelaxed()) {
+            // Задачи пула ссылаются на куски, поэтому дожидаемся их
+            while (!jobs.empty())
+                collect(false);
+            emit finished(imported, rejected, timer.elapsed(), true);
+            return;
+        }
+
+        QByteArray chunk = file.read(kChunkSize);
+        if (chunk.isEmpty())
+            break;
+        if (atStart && chunk.startsWith("\xEF\xBB\xBF"))
+            chunk.remove(0, 3);
+        atStart = false;
+
+        carry += chunk;
+        const int cut = recordBoundary(format, carry);
+        if (cut > 0) {
+            submit(carry.left(cut));
+            carry.remove(0, cut);
+        }
+        emit progress(file.pos(), total);
+    }
+    if (!carry.isEmpty())
+        submit(carry);
+    while (!jobs.empty())
+        collect(true);
+
+    emit progress(total, total);
+    emit finished(imported, rejected, timer.elapsed(), false);
+}
@@ -0,0 +1,69 @@
+#ifndef QUIZIMPORTER_H
+#define QUIZIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QByteArray>
+#include <QAtomicInt>
+
+#include "question.h"
+
+class QThread;
+
+// Массовый импорт вопросов из CSV, GIFT (Moodle) и Markdown. Рабочий поток
+// читает файл кусками по ~1 МБ, режет их по границам записей и отдаёт
+// разбор в общий пул потоков; готовые куски выдаются строго по порядку
+// файла, так что вопросы приходят в исходной последовательности. Ошибки
+// привязаны к номеру строки исходного файла.
+//
+// CSV: вопрос, вариант 1..4, правильные (номера 1-4 или буквы A-D через
+// любой разделитель), сложность 1-3 (необязательно). Разделитель полей
+// (запятая, точка с запятой или табуляция) определяется по первой строке;
+// строка заголовка пропускается.
+// GIFT: вопросы с четырьмя вариантами "=верный ~неверный" или "~%50%...",
+// записи разделяются пустой строкой.
+// Markdown: "## Вопрос", затем "- [x] вариант" / "- [ ] вариант" и
+// необязательная строка "Сложность: N".
+class QuizImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format { Csv, Gift, Markdown, Unknown };
+
+    struct Chunk
+    {
+        QVector<Question> questions;
+        QStringList errors;
+    };
+
+    explicit QuizImporter(const QString &fileName, QObject *parent = nullptr);
+    ~QuizImporter();
+
+    static Format formatOf(const QString &fileName);
+    static QString fileFilter();
+
+    // Разбор одного куска, начинающегося со строки firstLine исходного файла
+    static Chunk parse(Format format, const QByteArray &data, qint64 firstLine,
+                       char delimiter = ',', bool mayHaveHeader = false);
+
+    void start();
+    void cancel();
+
+signals:
+    void questionsImported(const QVector<Question> &batch);
+    void rowsRejected(const QStringList &errors);
+    void progress(qint64 bytesRead, qint64 totalBytes);
+    void finished(int imported, int rejected, qint64 elapsedMs, bool cancelled);
+
+private:
+    void run();
+
+    QString fileName;
+    QThread *thread = nullptr;
+    QAtomicInt cancelled;
+};
+
+#endif // QUIZIMPORTER_H
@@ -0,0 +1,93 @@
+#include "quizlibrary.h"
+#include "quizscanner.h"
+#include "librarymodel.h"
+
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSettings>
+#include <QSortFilterProxyModel>
+#include <QVBoxLayout>
+
+namespace {
+const char kOrganization[] = "QuizApp";
+const char kDirectoryKey[] = "library/directory";
+}
+
+QuizLibrary::QuizLibrary(QWidget *parent)
+    : QWidget(parent)
+{
+    setWindowFlag(Qt::Window);
+    setWindowTitle("Библиотека викторин");
+
+    catalog.load(QuizCatalog::defaultPath());
+    scanner = new QuizScanner(&catalog, QuizCatalog::defaultPath(), this);
+    model = new LibraryModel(&catalog, this);
+
+    auto *mainLayout = new QVBoxLayout(this);
+    auto *dirRow = new QHBoxLayout;
+    dirLabel = new QLabel(this);
+    chooseButton = new QPushButton("Выбрать папку…", this);
+    dirRow->addWidget(dirLabel, 1);
+    dirRow->addWidget(chooseButton);
+    mainLayout->addLayout(dirRow);
+
+    auto *proxy = new QSortFilterProxyModel(this);
+    proxy->setSourceModel(model);
+    tableView = new QTableView(this);
+    tableView->setModel(proxy);
+    tableView->setSortingEnabled(true);
+    tableView->sortByColumn(LibraryModel::FileColumn, Qt::AscendingOrder);
+    tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tableView->verticalHeader()->hide();
+    tableView->horizontalHeader()->setSectionResizeMode(LibraryModel::FileColumn, QHeaderView::Stretch);
+    mainLayout->addWidget(tableView);
+
+    statusLabel = new QLabel(this);
+    mainLayout->addWidget(statusLabel);
+
+    connect(chooseButton, &QPushButton::clicked, this, &QuizLibrary::chooseDirectory);
+    connect(tableView, &QTableView::activated, this, &QuizLibrary::onActivated);
+    connect(scanner, &QuizScanner::entryChanged, model, &LibraryModel::entryChanged);
+    connect(scanner, &QuizScanner::entryRemoved, model, &LibraryModel::entryRemoved);
+    connect(scanner, &QuizScanner::progress, this, &QuizLibrary::onProgress);
+    connect(scanner, &QuizScanner::finished, this, [this]() {
+        statusLabel->setText(QString("Викторин: %1").arg(model->rowCount()));
+    });
+
+    const QString lastDir = QSettings(kOrganization, "QuizApp").value(kDirectoryKey).toString();
+    if (!lastDir.isEmpty())
+        openDirectory(lastDir);
+}
+
+void QuizLibrary::chooseDirectory()
+{
+    const QString dirPath = QFileDialog::getExistingDirectory(this, "Папка с викторинами", scanner->directory());
+    if (dirPath.isEmpty())
+        return;
+    QSettings(kOrganization, "QuizApp").setValue(kDirectoryKey, dirPath);
+    openDirectory(dirPath);
+}
+
+void QuizLibrary::openDirectory(const QString &dirPath)
+{
+    dirLabel->setText(dirPath);
+    // Сначала то, что уже известно из каталога, затем фоновая проверка папки
+    model->setDirectory(dirPath);
+    statusLabel->setText(QString("Викторин: %1, проверка папки…").arg(model->rowCount()));
+    scanner->setDirectory(dirPath);
+}
+
+void QuizLibrary::onActivated(const QModelIndex &index)
+{
+    const auto *proxy = static_cast<const QSortFilterProxyModel *>(tableView->model());
+    const QString path = model->pathAt(proxy->mapToSource(index).row());
+    if (!path.isEmpty())
+        emit quizChosen(path);
+}
+
+void QuizLibrary::onProgress(int done, int total)
+{
+    statusLabel->setText(QString("Разбор файлов: %1 из %2").arg(done).arg(total));
+}
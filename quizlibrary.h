@@ -0,0 +1,43 @@
+#ifndef QUIZLIBRARY_H
+#define QUIZLIBRARY_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableView>
+
+#include "quizcatalog.h"
+
+class QuizScanner;
+class LibraryModel;
+
+// Окно библиотеки: список викторин папки строится сразу из сохранённого
+// каталога, а фоновый сканер дописывает новые и изменённые файлы.
+class QuizLibrary : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit QuizLibrary(QWidget *parent = nullptr);
+
+signals:
+    void quizChosen(const QString &fileName);
+
+private slots:
+    void chooseDirectory();
+    void onActivated(const QModelIndex &index);
+    void onProgress(int done, int total);
+
+private:
+    void openDirectory(const QString &dirPath);
+
+    QuizCatalog catalog;
+    QuizScanner *scanner;
+    LibraryModel *model;
+    QLabel *dirLabel;
+    QLabel *statusLabel;
+    QPushButton *chooseButton;
+    QTableView *tableView;
+};
+
+#endif // QUIZLIBRARY_H
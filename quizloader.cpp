@@ -0,0 +1,218 @@
+#include "quizloader.h"
+#include "quizbinary.h"
+
+#include <QThread>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QMetaType>
+
+namespace {
+
+const qint64 kChunkSize = 1 << 20;
+const int kMaxBatch = 1024;
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+} // namespace
+
+QuizLoader::QuizLoader(const QString &fileName, QObject *parent)
+    : QObject(parent), fileName(fileName)
+{
+    qRegisterMetaType<QVector<Question>>("QVector<Question>");
+}
+
+QuizLoader::~QuizLoader()
+{
+    cancel();
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void QuizLoader::start()
+{
+    if (thread)
+        return;
+
+    thread = QThread::create([this]() {
+        if (QuizBinary::isCompiledFile(fileName))
+            runCompiled();
+        else
+            run();
+    });
+    thread->start();
+}
+
+void QuizLoader::cancel()
+{
+    cancelled.storeRelaxed(1);
+}
+
+bool QuizLoader::flush(QVector<Question> &batch, int &batchLimit, bool force)
+{
+    if (batch.isEmpty() || (!force && batch.size() < batchLimit))
+        return false;
+
+    emit questionsLoaded(batch);
+    batch.clear();
+    batchLimit = qMin(batchLimit * 2, kMaxBatch);
+    return true;
+}
+
+void QuizLoader::run()
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit failed(0, file.errorString());
+        emit finished(0, false);
+        return;
+    }
+
+    const qint64 total = file.size();
+    QByteArray buffer;
+    qint64 base = 0;
+    int pos = 0;
+    int objectStart = -1;
+    int depth = 0;
+    bool started = false;
+    bool ended = false;
+    bool inString = false;
+    bool escape = false;
+
+    int count = 0;
+    QVector<Question> batch;
+    int batchLimit = 1;
+
+    auto fail = [&](qint64 offset, const QString &message) {
+        flush(batch, batchLimit, true);
+        emit failed(offset, message);
+        emit finished(count, false);
+    };
+
+    while (!ended) {
+        if (cancelled.loadRelaxed()) {
+            flush(batch, batchLimit, true);
+            emit finished(count, true);
+            return;
+        }
+
+        const QByteArray chunk = file.read(kChunkSize);
+        if (chunk.isEmpty())
+            break;
+        buffer.append(chunk);
+        if (base == 0 && pos == 0 && buffer.startsWith("\xEF\xBB\xBF"))
+            pos = 3;
+
+        // Ищем границы объектов верхнего уровня, каждый разбираем отдельно
+        for (; pos < buffer.size() && !ended; ++pos) {
+            const char c = buffer.at(pos);
+            if (inString) {
+                if (escape)
+                    escape = false;
+                else if (c == '\\')
+                    escape = true;
+                else if (c == '"')
+                    inString = false;
+                continue;
+            }
+
+            if (!started) {
+                if (isSpace(c))
+                    continue;
+                if (c != '[') {
+                    fail(base + pos, "Ожидался массив вопросов");
+                    return;
+                }
+                started = true;
+                continue;
+            }
+
+            if (depth == 0) {
+                if (isSpace(c) || c == ',')
+                    continue;
+                if (c == ']') {
+                    ended = true;
+                    continue;
+                }
+                if (c != '{') {
+                    fail(base + pos, "Элемент массива не является объектом");
+                    return;
+                }
+                objectStart = pos;
+                depth = 1;
+                continue;
+            }
+
+            if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                QJsonParseError error;
+                const QJsonDocument doc = QJsonDocument::fromJson(
+                    buffer.mid(objectStart, pos - objectStart + 1), &error);
+                if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+                    fail(base + objectStart + error.offset, error.errorString());
+                    return;
+                }
+                batch.append(Question::fromJson(doc.object()));
+                ++count;
+                objectStart = -1;
+                flush(batch, batchLimit, false);
+            }
+        }
+
+        // Разобранное начало буфера больше не нужно
+        const int keepFrom = objectStart >= 0 ? objectStart : pos;
+        buffer.remove(0, keepFrom);
+        base += keepFrom;
+        pos -= keepFrom;
+        if (objectStart >= 0)
+            objectStart = 0;
+
+        flush(batch, batchLimit, true);
+        emit progress(file.pos(), total);
+    }
+
+    if (!ended) {
+        fail(total, started ? "Неожиданный конец файла" : "Файл пуст");
+        return;
+    }
+
+    flush(batch, batchLimit, true);
+    emit progress(total, total);
+    emit finished(count, false);
+}
+
+void QuizLoader::runCompiled()
+{
+    QuizBinary compiled;
+    if (!compiled.open(fileName)) {
+        emit failed(0, compiled.errorString());
+        emit finished(0, false);
+        return;
+    }
+
+    const int count = compiled.count();
+    QVector<Question> batch;
+    int batchLimit = 1;
+    for (int i = 0; i < count; ++i) {
+        if (cancelled.loadRelaxed()) {
+            flush(batch, batchLimit, true);
+            emit finished(i, true);
+            return;
+        }
+        batch.append(compiled.question(i));
+        if (flush(batch, batchLimit, false))
+            emit progress(i + 1, count);
+    }
+
+    flush(batch, batchLimit, true);
+    emit progress(count, count);
+    emit finished(count, false);
+}
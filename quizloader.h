@@ -0,0 +1,45 @@
+#ifndef QUIZLOADER_H
+#define QUIZLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QAtomicInt>
+
+#include "question.h"
+
+class QThread;
+
+// Потоковая загрузка викторины в рабочем потоке. JSON-массив разбирается
+// по одному объекту, не читая файл целиком; вопросы приходят пачками
+// (первая — из одного вопроса, дальше пачки растут), так что окно может
+// показывать их, пока файл ещё читается.
+class QuizLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QuizLoader(const QString &fileName, QObject *parent = nullptr);
+    ~QuizLoader();
+
+    void start();
+    void cancel();
+
+signals:
+    void questionsLoaded(const QVector<Question> &batch);
+    void progress(qint64 bytesRead, qint64 totalBytes);
+    void failed(qint64 offset, const QString &message);
+    void finished(int count, bool cancelled);
+
+private:
+    void run();
+    void runCompiled();
+
+    bool flush(QVector<Question> &batch, int &batchLimit, bool force);
+
+    QString fileName;
+    QThread *thread = nullptr;
+    QAtomicInt cancelled;
+};
+
+#endif // QUIZLOADER_H
@@ -0,0 +1,156 @@
+#include "quizscanner.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSet>
+
+namespace {
+// Пауза после уведомления: копирование файла даёт серию событий подряд
+const int kSettleMs = 500;
+const int kPollMs = 60000;
+}
+
+QuizScanner::QuizScanner(QuizCatalog *catalog, const QString &catalogPath, QObject *parent)
+    : QObject(parent), catalog(catalog), catalogPath(catalogPath)
+{
+    settleTimer.setSingleShot(true);
+    settleTimer.setInterval(kSettleMs);
+    pollTimer.setInterval(kPollMs);
+    connect(&settleTimer, &QTimer::timeout, this, &QuizScanner::rescan);
+    connect(&pollTimer, &QTimer::timeout, this, &QuizScanner::rescan);
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, &settleTimer, qOverload<>(&QTimer::start));
+}
+
+QuizScanner::~QuizScanner()
+{
+    // Задачи пула обращаются к объекту, поэтому дожидаемся их здесь
+    pool.clear();
+    pool.waitForDone();
+}
+
+void QuizScanner::setDirectory(const QString &path)
+{
+    const QStringList watched = watcher.directories();
+    if (!watched.isEmpty())
+        watcher.removePaths(watched);
+
+    dirPath = QDir(path).absolutePath();
+    ++generation;
+    scanning = false;
+    rescanPending = false;
+    watcher.addPath(dirPath);
+    pollTimer.start();
+    rescan();
+}
+
+void QuizScanner::rescan()
+{
+    if (dirPath.isEmpty())
+        return;
+    if (scanning) {
+        rescanPending = true;
+        return;
+    }
+    scanning = true;
+    scanTotal = 0;
+    scanDone = 0;
+
+    const int current = generation;
+    const QString root = dirPath;
+    pool.start([this, current, root]() {
+        QVector<FileStamp> files;
+        QStringList dirs;
+        QDirIterator it(root, {"*.json", "*.quizbin"}, QDir::Files | QDir::AllDirs | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            if (info.isDir()) {
+                dirs << info.absoluteFilePath();
+            } else {
+                files.append({info.absoluteFilePath(), info.lastModified().toMSecsSinceEpoch(), info.size()});
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, current, files, dirs]() {
+            listed(current, files, dirs);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void QuizScanner::listed(int current, const QVector<FileStamp> &files, const QStringList &dirs)
+{
+    if (current != generation)
+        return;
+
+    // Подпапки, появившиеся с прошлого прохода, тоже отслеживаются
+    const QStringList watched = watcher.directories();
+    QStringList added;
+    for (const QString &dir : dirs) {
+        if (!watched.contains(dir))
+            added << dir;
+    }
+    if (!added.isEmpty())
+        watcher.addPaths(added);
+
+    QSet<QString> present;
+    for (const FileStamp &file : files) {
+        present.insert(file.path);
+        const QuizCatalog::Entry *known = catalog->find(file.path);
+        if (known && known->size == file.size && known->modified == file.modified)
+            continue;
+
+        ++scanTotal;
+        const QuizCatalog::Entry previous = known ? *known : QuizCatalog::Entry();
+        const QString path = file.path;
+        pool.start([this, current, path, previous]() {
+            const QuizCatalog::Entry entry = QuizCatalog::scan(path, previous.path.isEmpty() ? nullptr : &previous);
+            QMetaObject::invokeMethod(this, [this, current, entry]() {
+                scanned(current, entry);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    bool removed = false;
+    for (const QuizCatalog::Entry &entry : catalog->entriesUnder(dirPath)) {
+        if (!present.contains(entry.path)) {
+            catalog->remove(entry.path);
+            emit entryRemoved(entry.path);
+            removed = true;
+        }
+    }
+
+    if (scanTotal == 0) {
+        if (removed)
+            catalog->save(catalogPath);
+        finishPass();
+    } else {
+        emit progress(0, scanTotal);
+    }
+}
+
+void QuizScanner::scanned(int current, const QuizCatalog::Entry &entry)
+{
+    if (current != generation)
+        return;
+
+    catalog->insert(entry);
+    emit entryChanged(entry.path);
+    emit progress(++scanDone, scanTotal);
+
+    if (scanDone == scanTotal) {
+        catalog->save(catalogPath);
+        finishPass();
+    }
+}
+
+void QuizScanner::finishPass()
+{
+    scanning = false;
+    emit finished();
+    if (rescanPending) {
+        rescanPending = false;
+        rescan();
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef QUIZSCANNER_H
+#define QUIZSCANNER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QThreadPool>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+#include "quizcatalog.h"
+
+// Фоновое обновление каталога по папке с викторинами. Обход папки и разбор
+// файлов идут в собственном пуле потоков; заново разбираются только новые и
+// изменённые (по размеру и времени) файлы, по нескольку одновременно.
+// Каталог меняется только в потоке объекта, после каждого прохода он
+// сохраняется на диск. Папка отслеживается QFileSystemWatcher, а на сетевых
+// дисках, где уведомления не приходят, — ещё и периодическим проходом.
+class QuizScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct FileStamp
+    {
+        QString path;
+        qint64 modified = 0;
+        qint64 size = 0;
+    };
+
+    QuizScanner(QuizCatalog *catalog, const QString &catalogPath, QObject *parent = nullptr);
+    ~QuizScanner();
+
+    void setDirectory(const QString &dirPath);
+    QString directory() const { return dirPath; }
+    bool isScanning() const { return scanning; }
+
+public slots:
+    void rescan();
+
+signals:
+    void entryChanged(const QString &path);
+    void entryRemoved(const QString &path);
+    void progress(int done, int total);
+    void finished();
+
+private:
+    void listed(int generation, const QVector<FileStamp> &files, const QStringList &dirs);
+    void scanned(int generation, const QuizCatalog::Entry &entry);
+    void finishPass();
+
+    QuizCatalog *catalog;
+    QString catalogPath;
+    QString dirPath;
+    QThreadPool pool;
+    QFileSystemWatcher watcher;
+    QTimer settleTimer;
+    QTimer pollTimer;
+    int generation = 0;
+    bool scanning = false;
+    bool rescanPending = false;
+    int scanTotal = 0;
+    int scanDone = 0;
+};
+
+#endif // QUIZSCANNER_H
@@ -0,0 +1,244 @@
+#include "sessionserver.h"
+#include "sessionclient.h"
+#include "quizsource.h"
+#include "quizgenerator.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <random>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+// QuizServer — ведущий сессии класса: раздаёт викторину подключённым
+// QuizApp («Файл → Подключиться к сессии»), принимает ответы и рассылает
+// таблицу лидеров. С --loadtest N поднимает сервер и N клиентов в одном
+// процессе на петлевом интерфейсе и печатает задержки доставки вопросов
+// и ответов.
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// У каждого клиента теста два сокета в процессе; обычного лимита 1024 не хватит
+void raiseFileLimit()
+{
+#ifdef Q_OS_UNIX
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+qint64 percentile(QVector<qint64> samples, double p)
+{
+    if (samples.isEmpty())
+        return 0;
+    const int k = qMin(int(samples.size()) - 1, int(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+int serve(const QString &fileName, quint16 port, int waitFor, int delaySeconds, quint64 seed)
+{
+    SessionServer server;
+    if (!server.open(fileName) || !server.listen(QHostAddress::Any, port)) {
+        err() << "Ошибка: " << server.errorString() << "\n";
+        return 1;
+    }
+    out() << "Сессия " << fileName << " на порту " << server.port() << "\n";
+    out().flush();
+
+    // Старт — когда подключится waitFor участников или через delaySeconds после первого
+    QTimer startTimer;
+    startTimer.setSingleShot(true);
+    QObject::connect(&startTimer, &QTimer::timeout, &server, [&]() { server.startSession(seed); });
+    QObject::connect(&server, &SessionServer::clientJoined, &server, [&](int count) {
+        out() << "Участников: " << count << "\n";
+        out().flush();
+        if (server.isRunning())
+            return;
+        if (waitFor > 0 && count >= waitFor)
+            server.startSession(seed);
+        else if (!startTimer.isActive())
+            startTimer.start(delaySeconds * 1000);
+    });
+    QObject::connect(&server, &SessionServer::questionStarted, &server, [&](int position) {
+        out() << "Вопрос " << position + 1 << " из " << server.questionCount() << "\n";
+        out().flush();
+    });
+    QObject::connect(&server, &SessionServer::sessionFinished, &server, [&]() {
+        if (!server.errorString().isEmpty())
+            err() << server.errorString() << "\n";
+        out() << "Сессия завершена\n";
+        QTimer::singleShot(1000, qApp, &QCoreApplication::quit);
+    });
+    return QCoreApplication::exec();
+}
+
+int loadTest(QString fileName, int clientCount, int thinkMs, quint64 seed)
+{
+    raiseFileLimit();
+
+    QTemporaryDir dir;
+    if (fileName.isEmpty()) {
+        QuizGenerator::Options options;
+        options.seed = seed;
+        QuizGenerator generator(options);
+        QVector<Question> questions;
+        for (int i = 0; i < 20; ++i)
+            questions.append(generator.nextQuestion());
+        fileName = dir.filePath("loadtest.quizbin");
+        QString error;
+        if (!QuizSource::save(questions, fileName, &error)) {
+            err() << "Не удалось создать викторину: " << error << "\n";
+            return 1;
+        }
+    }
+
+    SessionServer server;
+    server.setSaveResults(false);
+    if (!server.open(fileName) || !server.listen(QHostAddress::LocalHost, 0)) {
+        err() << "Ошибка: " << server.errorString() << "\n";
+        return 1;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    QVector<qint64> shownAt;
+    QVector<qint64> delivery;
+    QVector<qint64> roundTrip;
+    QVector<qint64> answerSent(clientCount, 0);
+    int welcomed = 0;
+    int finished = 0;
+    int failures = 0;
+    bool started = false;
+    qint64 allJoinedMs = 0;
+    std::mt19937 rng(quint32(seed));
+
+    QObject::connect(&server, &SessionServer::questionStarted, &server, [&](int position) {
+        shownAt.resize(position + 1);
+        shownAt[position] = clock.nsecsElapsed();
+    });
+
+    QVector<SessionClient *> clients;
+    auto quitIfDone = [&]() {
+        if (finished + failures >= clientCount)
+            QCoreApplication::quit();
+    };
+    // Сессия начинается, когда все клиенты либо подключились, либо отвалились
+    auto startIfReady = [&]() {
+        if (started || welcomed == 0 || welcomed + failures < clientCount)
+            return;
+        started = true;
+        allJoinedMs = clock.elapsed();
+        server.startSession(seed);
+    };
+
+    for (int i = 0; i < clientCount; ++i) {
+        auto *client = new SessionClient(&server);
+        clients.append(client);
+
+        QObject::connect(client, &SessionClient::welcomed, client, [&]() {
+            ++welcomed;
+            startIfReady();
+        });
+        QObject::connect(client, &SessionClient::questionShown, client,
+                         [&, client, i](int position, int, const QString &, const QStringList &, int, int remaining) {
+            if (position < shownAt.size())
+                delivery.append(clock.nsecsElapsed() - shownAt[position]);
+            const int delay = int(rng() % quint32(qMax(1, qMin(thinkMs, remaining))));
+            const quint8 mask = quint8(1 + rng() % 15);
+            QTimer::singleShot(delay, client, [&, client, i, position, mask]() {
+                answerSent[i] = clock.nsecsElapsed();
+                client->sendAnswer(position, mask);
+            });
+        });
+        QObject::connect(client, &SessionClient::answerResult, client, [&, i]() {
+            roundTrip.append(clock.nsecsElapsed() - answerSent[i]);
+        });
+        QObject::connect(client, &SessionClient::finished, client, [&]() {
+            ++finished;
+            quitIfDone();
+        });
+        QObject::connect(client, &SessionClient::failed, client, [&](const QString &message) {
+            if (failures++ < 10)
+                err() << "Клиент: " << message << "\n";
+            startIfReady();
+            quitIfDone();
+        });
+    }
+
+    // Подключаемся волнами, чтобы не переполнить очередь приёма соединений
+    int connected = 0;
+    QTimer connectTimer;
+    QObject::connect(&connectTimer, &QTimer::timeout, &server, [&]() {
+        for (int k = 0; k < 100 && connected < clientCount; ++k, ++connected)
+            clients[connected]->connectToServer("127.0.0.1", server.port(), QString("user%1").arg(connected));
+        if (connected == clientCount)
+            connectTimer.stop();
+    });
+    connectTimer.start(5);
+
+    QCoreApplication::exec();
+
+    auto ms = [](qint64 ns) { return QString::number(ns / 1e6, 'f', 2); };
+    out() << "Клиентов: " << clientCount << ", завершили: " << finished << ", ошибок: " << failures << "\n"
+          << "Все подключены за " << allJoinedMs << " мс, сессия заняла " << clock.elapsed() - allJoinedMs << " мс\n"
+          << "Доставка вопроса, мс: p50 " << ms(percentile(delivery, 0.5)) << ", p99 " << ms(percentile(delivery, 0.99))
+          << ", max " << ms(percentile(delivery, 1.0)) << "\n"
+          << "Ответ -> результат, мс: p50 " << ms(percentile(roundTrip, 0.5)) << ", p99 " << ms(percentile(roundTrip, 0.99))
+          << ", max " << ms(percentile(roundTrip, 1.0)) << "\n";
+    return finished == clientCount ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizServer");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Сессия викторины для класса по сети и нагрузочный тест на петлевом интерфейсе.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("викторина", "файл .json или .quizbin (для --loadtest необязателен)");
+    const QCommandLineOption portOption("port", "Порт сервера", "P", "5050");
+    const QCommandLineOption waitOption("wait", "Начать, когда подключится N участников", "N", "0");
+    const QCommandLineOption delayOption("delay", "Начать через S секунд после первого участника", "S", "60");
+    const QCommandLineOption seedOption("seed", "Зерно порядка вопросов и вариантов", "S");
+    const QCommandLineOption loadOption("loadtest", "Нагрузочный тест: N клиентов в этом же процессе", "N");
+    const QCommandLineOption thinkOption("think-ms", "loadtest: наибольшая пауза перед ответом, мс", "ms", "500");
+    parser.addOptions({portOption, waitOption, delayOption, seedOption, loadOption, thinkOption});
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const quint64 seed = parser.isSet(seedOption) ? parser.value(seedOption).toULongLong() : SessionPlan::randomSeed();
+
+    if (parser.isSet(loadOption)) {
+        return loadTest(args.value(0), qMax(1, parser.value(loadOption).toInt()),
+                        parser.value(thinkOption).toInt(), seed);
+    }
+    if (args.size() != 1)
+        parser.showHelp(2);
+    return serve(args[0], quint16(parser.value(portOption).toUInt()), parser.value(waitOption).toInt(),
+                 parser.value(delayOption).toInt(), seed);
+}
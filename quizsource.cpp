@@ -0,0 +1,120 @@
+#include "quizsource.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+bool QuizSource::open(const QString &fileName)
+{
+    parsed.clear();
+    released = 0;
+    overrides.clear();
+    compiled.reset();
+    error.clear();
+
+    if (QuizBinary::isCompiledFile(fileName)) {
+        compiled.reset(new QuizBinary);
+        if (!compiled->open(fileName)) {
+            error = compiled->errorString();
+            compiled.reset();
+            return false;
+        }
+        return true;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = QString("%1 (позиция %2)").arg(parseError.errorString()).arg(parseError.offset);
+        return false;
+    }
+    const QJsonArray array = doc.array();
+    parsed.reserve(array.size());
+    for (const QJsonValue &val : array)
+        parsed.append(Question::fromJson(val.toObject()));
+    return true;
+}
+
+void QuizSource::append(const QVector<Question> &batch)
+{
+    parsed += batch;
+}
+
+void QuizSource::releaseParsed()
+{
+    released += parsed.size();
+    parsed = QVector<Question>();
+}
+
+int QuizSource::count() const
+{
+    return compiled ? compiled->count() : released + parsed.size();
+}
+
+void QuizSource::setOverrides(const QHash<int, Question> &questions)
+{
+    overrides = questions;
+}
+
+int QuizSource::difficulty(int index) const
+{
+    auto it = overrides.constFind(index);
+    if (it != overrides.constEnd())
+        return it->difficulty;
+    if (compiled)
+        return compiled->difficulty(index);
+    return index >= released ? parsed[index - released].difficulty : 1;
+}
+
+Question QuizSource::question(int index) const
+{
+    auto it = overrides.constFind(index);
+    if (it != overrides.constEnd())
+        return it.value();
+    if (compiled)
+        return compiled->question(index);
+    return index >= released ? parsed[index - released] : Question();
+}
+
+QVector<Question> QuizSource::questions() const
+{
+    QVector<Question> all = compiled ? compiled->questions() : parsed;
+    if (!compiled && released > 0)
+        all.insert(0, released, Question());
+    for (auto it = overrides.constBegin(); it != overrides.constEnd(); ++it) {
+        if (it.key() >= 0 && it.key() < all.size())
+            all[it.key()] = it.value();
+    }
+    return all;
+}
+
+bool QuizSource::save(const QVector<Question> &questions, const QString &fileName, QString *error)
+{
+    if (fileName.endsWith(".quizbin", Qt::CaseInsensitive))
+        return QuizBinary::write(questions, fileName, error);
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    QJsonArray array;
+    for (const Question &q : questions)
+        array.append(q.toJson());
+    file.write(QJsonDocument(array).toJson());
+    if (!file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
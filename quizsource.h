@@ -0,0 +1,42 @@
+#ifndef QUIZSOURCE_H
+#define QUIZSOURCE_H
+
+#include <QString>
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
+
+#include "question.h"
+#include "quizbinary.h"
+
+// Вопросы викторины из JSON-файла или из скомпилированного *.quizbin.
+// Для скомпилированного файла вопросы распаковываются только по запросу.
+class QuizSource
+{
+public:
+    bool open(const QString &fileName);
+    void append(const QVector<Question> &batch);
+    // Освобождает разобранные из JSON вопросы, когда они уже скомпилированы
+    // (CompiledQuiz): нумерация следующих пакетов продолжается, а обращение
+    // к освобождённым номерам возвращает пустой вопрос
+    void releaseParsed();
+    void setOverrides(const QHash<int, Question> &questions);
+    QString errorString() const { return error; }
+
+    bool isCompiled() const { return !compiled.isNull(); }
+    int count() const;
+    int difficulty(int index) const;
+    Question question(int index) const;
+    QVector<Question> questions() const;
+
+    static bool save(const QVector<Question> &questions, const QString &fileName, QString *error = nullptr);
+
+private:
+    QVector<Question> parsed;
+    int released = 0;           // номер первого вопроса в parsed
+    QHash<int, Question> overrides;
+    QSharedPointer<QuizBinary> compiled;
+    QString error;
+};
+
+#endif // QUIZSOURCE_H
@@ -1,4 +1,10 @@
 #include "quiztaker.h"
+#include "scorestore.h"
+#include "scoretablemodel.h"
+#include "quizloader.h"
+#include "quizdeltalog.h"
+#include "sessionclient.h"
+#include "itemcalibration.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonDocument>
@@ -7,10 +13,89 @@
 #include <QInputDialog>
 #include <QHeaderView>
 #include <QComboBox>
-#include <random>
 
-QuizTaker::QuizTaker(const QString &fileName, QWidget *parent)
-    : QWidget(parent), currentQuestionIndex(0), score(0)
+namespace {
+// Частота обновления надписи таймера; сам срок от неё не зависит
+const int kTimerTickMs = 200;
+}
+
+QuizTaker::QuizTaker(const QString &fileName, const SessionPlan::Request &request, QWidget *parent)
+    : QWidget(parent), plan(request), currentQuestionIndex(0), score(0)
+{
+    buildLayout();
+    quizPath = fileName;
+    quizFileName = QFileInfo(fileName).fileName();
+
+    // Скомпилированный файл читается лениво, JSON — потоково в рабочем потоке
+    if (QuizBinary::isCompiledFile(fileName)) {
+        if (!quizData.open(fileName))
+            QMessageBox::critical(this, "Ошибка", "Не удалось открыть викторину.\n" + quizData.errorString());
+        quizData.setOverrides(QuizDeltaLog::read(fileName));
+        loadingFinished = true;
+        loadProgress->hide();
+        addQuestions(0, quizData.count());
+        if (needsWholeBank()) {
+            planWholeBank();
+            addPlanTime(0, plan.count());
+        }
+        startClock();
+        loadQuestion();
+    } else {
+        quizData.setOverrides(QuizDeltaLog::read(fileName));
+        loadQuestion();
+        startLoading(fileName);
+    }
+}
+
+// Участие в сессии класса: вопросы, срок и баллы приходят от сервера,
+// здесь только показ и отправка отмеченных вариантов
+QuizTaker::QuizTaker(SessionClient *client, QWidget *parent)
+    : QWidget(parent), currentQuestionIndex(0), score(0), remote(client)
+{
+    buildLayout();
+    loadProgress->hide();
+    remote->setParent(this);
+
+    standingsLabel = new QLabel(this);
+    standingsLabel->setWordWrap(true);
+    layout->insertWidget(layout->indexOf(timerLabel) + 1, standingsLabel);
+
+    questionLabel->setText("Подключение к серверу…");
+    submitButton->setEnabled(false);
+
+    connect(remote, &SessionClient::welcomed, this, [this](const QString &quiz, int questionCount) {
+        quizFileName = quiz;
+        setWindowTitle(QString("Сессия: %1").arg(quiz));
+        questionLabel->setText(QString("Ожидание начала сессии (%1 вопросов)…").arg(questionCount));
+    });
+    connect(remote, &SessionClient::questionShown, this, &QuizTaker::showRemoteQuestion);
+    connect(remote, &SessionClient::answerResult, this, [this](int, int points, int total) {
+        score = total;
+        timerLabel->setText(QString("Ответ принят: +%1, всего %2. Ждём остальных…").arg(points).arg(total));
+    });
+    connect(remote, &SessionClient::standings, this, [this](const QVector<SessionProtocol::Standing> &rows) {
+        QStringList lines;
+        for (int i = 0; i < rows.size(); ++i)
+            lines << QString("%1. %2 — %3").arg(i + 1).arg(rows[i].name).arg(rows[i].score);
+        standingsLabel->setText("Лидеры:\n" + lines.join('\n'));
+    });
+    connect(remote, &SessionClient::finished, this, &QuizTaker::finishRemote);
+    connect(remote, &SessionClient::failed, this, [this](const QString &message) {
+        quizTimer->stop();
+        QMessageBox::critical(this, "Ошибка", "Сессия прервана.\n" + message);
+        exitButton->show();
+    });
+    connect(remote, &SessionClient::disconnected, this, [this]() {
+        if (!remoteFinished) {
+            quizTimer->stop();
+            submitButton->setEnabled(false);
+            questionLabel->setText("Соединение с сервером потеряно.");
+            exitButton->show();
+        }
+    });
+}
+
+void QuizTaker::buildLayout()
 {
     this->resize(800, 600);
     this->setMinimumSize(600, 400);
@@ -31,67 +116,17 @@ QuizTaker::QuizTaker(const QString &fileName, QWidget *parent)
 
     initScoreTable();
 
-    QFile file(fileName);
-    quizFileName = QFileInfo(fileName).fileName();
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray data = file.readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        quizData = doc.array();
-    } else {
-        QMessageBox::critical(this, "Ошибка", "Не удалось открыть викторину.");
-    }
-
-    this->setStyleSheet(R"(
-    QWidget {
-        background-color: #ffe4f0;
-        font-family: "Segoe UI", sans-serif;
-        font-size: 18px;
-    }
-    QLabel {
-        color: #d81b60;
-        font-size: 22px;
-        font-weight: bold;
-        padding: 8px;
-    }
-    QCheckBox {
-        color: #6a1b9a;
-        font-size: 20px;
-        padding: 6px;
-    }
-    QPushButton {
-        background-color: #ffaad4;
-        border: 2px solid white;
-        border-radius: 10px;
-        color: white;
-        font-weight: bold;
-        padding: 12px 20px;
-        font-size: 20px;
-    }
-    QPushButton:hover {
-        background-color: #ff8fb6;
-    })");
-
-    loadQuestion();
-
-    int totalSeconds = 0;
-    for (const QJsonValue &val : quizData) {
-        int difficulty = val.toObject().value("difficulty").toInt(1);
-        switch (difficulty) {
-        case 1: totalSeconds += 20; break;
-        case 2: totalSeconds += 35; break;
-        case 3: totalSeconds += 90; break;
-        default: totalSeconds += 35;
-        }
-    }
-    remainingTime = QTime(0, 0).addSecs(totalSeconds);
-
     timerLabel = new QLabel(this);
-    timerLabel->setText(remainingTime.toString("mm:ss"));
     layout->addWidget(timerLabel);
+    showRemainingTime();
+
+    loadProgress = new QProgressBar(this);
+    loadProgress->setRange(0, 0);
+    layout->addWidget(loadProgress);
 
     quizTimer = new QTimer(this);
+    quizTimer->setTimerType(Qt::CoarseTimer);
     connect(quizTimer, &QTimer::timeout, this, &QuizTaker::updateTimer);
-    quizTimer->start(1000);
 
     auto *btnRow = new QHBoxLayout;
     againButton = new QPushButton("Пройти снова", this);
@@ -107,83 +142,338 @@ QuizTaker::QuizTaker(const QString &fileName, QWidget *parent)
     connect(exitButton , &QPushButton::clicked, this, &QWidget::close);
 }
 
+void QuizTaker::showRemoteQuestion(int position, int total, const QString &text,
+                                   const QStringList &options, int, int remaining)
+{
+    currentQuestionIndex = position;
+    questionLabel->setText(QString("Вопрос %1 из %2:\n%3").arg(position + 1).arg(total).arg(text));
+    for (int i = 0; i < 4; ++i) {
+        optionBoxes[i]->setText(options.value(i));
+        optionBoxes[i]->setChecked(false);
+        optionBoxes[i]->setEnabled(true);
+    }
+    submitButton->setEnabled(true);
+
+    // Срок считается от момента получения: задержка сети съедает часть времени,
+    // но не даёт лишнего — окончательно решает сервер
+    questionLimitMs = remaining;
+    questionClock.start();
+    startClock();
+    showRemainingTime();
+}
+
+void QuizTaker::finishRemote(int finalScore, int rank, int participants)
+{
+    remoteFinished = true;
+    quizTimer->stop();
+    score = finalScore;
+
+    questionLabel->setText(QString("Сессия завершена. Вы набрали %1 балл(ов).").arg(score));
+    for (int i = 0; i < 4; ++i)
+        optionBoxes[i]->hide();
+    submitButton->hide();
+    timerLabel->hide();
+
+    rankLabel->setText(QString("Ваше место: %1 из %2").arg(rank).arg(participants));
+    layout->insertWidget(layout->indexOf(standingsLabel), rankLabel);
+    rankLabel->show();
+    exitButton->show();
+}
+
+void QuizTaker::startLoading(const QString &fileName)
+{
+    auto *loader = new QuizLoader(fileName, this);
+    connect(loader, &QuizLoader::questionsLoaded, this, &QuizTaker::onQuestionsLoaded);
+    connect(loader, &QuizLoader::progress, this, [this](qint64 done, qint64 total) {
+        loadProgress->setRange(0, 1000);
+        loadProgress->setValue(total > 0 ? int(done * 1000 / total) : 1000);
+    });
+    connect(loader, &QuizLoader::failed, this, [this](qint64 offset, const QString &message) {
+        QMessageBox::critical(this, "Ошибка",
+                              QString("Ошибка в файле викторины (байт %1): %2").arg(offset).arg(message));
+    });
+    connect(loader, &QuizLoader::finished, this, &QuizTaker::onLoadFinished);
+    loader->start();
+}
+
+void QuizTaker::onQuestionsLoaded(const QVector<Question> &batch)
+{
+    const int first = quizData.count();
+    quizData.append(batch);
+    addQuestions(first, quizData.count());
+    // Показ и экран итогов работают по session, разобранный пакет больше не нужен
+    quizData.releaseParsed();
+
+    // Выборка и адаптивный тест начинаются только в onLoadFinished: до этого
+    // срок сессии ещё не посчитан, и запущенные часы сразу показали бы «время вышло»
+    if (needsWholeBank())
+        return;
+
+    if (waitingForQuestions) {
+        waitingForQuestions = false;
+        if (!quizTimer->isActive())
+            startClock();
+        loadQuestion();
+    }
+}
+
+void QuizTaker::onLoadFinished(int, bool)
+{
+    loadingFinished = true;
+    loadProgress->hide();
+
+    // Выборку и адаптивный тест можно начать только по всему банку, поэтому они ждут конца загрузки
+    if (needsWholeBank()) {
+        planWholeBank();
+        addPlanTime(0, plan.count());
+        if (plan.count() > 0)
+            startClock();
+    }
+
+    if (plan.count() == 0) {
+        close();
+        return;
+    }
+
+    if (waitingForQuestions) {
+        waitingForQuestions = false;
+        loadQuestion();
+    }
+}
+
+void QuizTaker::addQuestions(int first, int last)
+{
+    // Разобранный JSON освобождается сразу после пакета, поэтому компилируется
+    // целиком; у *.quizbin заводятся только сложности, текст — по плану
+    if (quizData.isCompiled())
+        session.appendLazy(quizData, first, last);
+    else
+        session.append(quizData, first, last);
+    difficultyIndex.append(session, first, last);
+    if (!needsWholeBank()) {
+        plan.extendSequential(session.count());
+        addPlanTime(first, last);
+    }
+}
+
+void QuizTaker::addPlanTime(int first, int last)
+{
+    int seconds = 0;
+    for (int i = first; i < last; ++i) {
+        const int question = plan.item(i).question;
+        seconds += session.timeBudget(question, question + 1);
+    }
+    deadlineMs += qint64(seconds) * 1000;
+    showRemainingTime();
+}
+
+void QuizTaker::startPlan(quint64 seed)
+{
+    SessionPlan::Request request = plan.request();
+    request.seed = seed;
+    plan = SessionPlan(request);
+    if (needsWholeBank())
+        planWholeBank();
+    else
+        plan.extendSequential(session.count());
+}
+
+bool QuizTaker::needsWholeBank() const
+{
+    return plan.request().sampled || plan.request().adaptive();
+}
+
+void QuizTaker::planWholeBank()
+{
+    if (!plan.request().adaptive()) {
+        plan.sample(difficultyIndex);
+        return;
+    }
+
+    // Параметры и индекс строятся один раз на банк, повторное прохождение только освобождает вопросы
+    if (itemParameters.size() != session.count()) {
+        itemParameters = ItemCalibration::load(quizPath, session);
+        selector.build(itemParameters);
+    } else {
+        selector.reset();
+    }
+    ability = AbilityEstimate();
+    extendAdaptive();
+}
+
+void QuizTaker::extendAdaptive()
+{
+    const SessionPlan::Request &request = plan.request();
+    if (plan.count() >= request.adaptiveLength)
+        return;
+    if (request.targetError > 0 && ability.count() > 0 && ability.standardError() <= request.targetError)
+        return;
+
+    const int question = selector.next(ability.theta());
+    if (question < 0)
+        return;
+    selector.take(question);
+    plan.appendQuestion(question);
+}
+
+bool QuizTaker::perQuestionLimit() const
+{
+    // Длина адаптивного теста заранее неизвестна, поэтому срок у него всегда на вопрос
+    return plan.request().perQuestionLimit || plan.request().adaptive();
+}
+
+void QuizTaker::startClock()
+{
+    if (quizTimer->isActive())
+        return;
+    sessionClock.start();
+    quizTimer->start(kTimerTickMs);
+}
+
+qint64 QuizTaker::remainingMs() const
+{
+    if (remote || perQuestionLimit())
+        return questionClock.isValid() ? questionLimitMs - questionClock.elapsed() : questionLimitMs;
+    return sessionClock.isValid() ? deadlineMs - sessionClock.elapsed() : deadlineMs;
+}
+
+void QuizTaker::showRemainingTime()
+{
+    const qint64 seconds = (qMax<qint64>(remainingMs(), 0) + 999) / 1000;
+    timerLabel->setText(QTime(0, 0).addSecs(int(seconds)).toString("mm:ss"));
+}
+
 void QuizTaker::initScoreTable()
 {
-    scoreTable = new QTableWidget(this);
-    scoreTable->setColumnCount(2);
-    scoreTable->setHorizontalHeaderLabels({"ФИО", "Баллы"});
+    scoreModel = new ScoreTableModel(this);
+    scoreTable = new QTableView(this);
+    scoreTable->setModel(scoreModel);
     scoreTable->horizontalHeader()->setStretchLastSection(true);
+    scoreTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     scoreTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     scoreTable->setSelectionMode(QAbstractItemView::NoSelection);
     scoreTable->setFixedHeight(200);
     scoreTable->hide();
+
+    rankLabel = new QLabel(this);
+    rankLabel->hide();
 }
 
 void QuizTaker::loadQuestion()
 {
-    if (currentQuestionIndex >= quizData.size()) {
+    if (currentQuestionIndex >= plan.count()) {
+        if (!loadingFinished) {
+            waitingForQuestions = true;
+            questionLabel->setText("Загрузка вопросов…");
+            submitButton->setEnabled(false);
+            return;
+        }
         finishQuiz();
         return;
     }
+    submitButton->setEnabled(true);
 
-    QJsonObject obj = quizData[currentQuestionIndex].toObject();
-    QString question = obj["question"].toString();
-    QJsonArray optionsArray = obj["options"].toArray();
-
-    QJsonArray correctArray = obj["correct"].toArray();
-    QSet<QString> correctAnswers;
-    for (const QJsonValue &val : correctArray) {
-        int idx = val.toInt();
-        if (idx >= 0 && idx < optionsArray.size())
-            correctAnswers.insert(optionsArray[idx].toString());
-    }
-    currentCorrectAnswers = correctAnswers;
-
-    QStringList options;
-    for (const QJsonValue &val : optionsArray)
-        options << val.toString();
-
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(options.begin(), options.end(), g);
-
-    questionLabel->setText(QString("Вопрос %1:\n%2").arg(currentQuestionIndex + 1).arg(question));
+    // Порядок вариантов берётся из плана, ответ собирается в исходных индексах.
+    // Вопрос *.quizbin распаковывается только сейчас, когда он показывается
+    const SessionPlan::Item &item = plan.item(currentQuestionIndex);
+    session.compile(quizData, item.question);
+    questionLabel->setText(QString("Вопрос %1:\n%2").arg(currentQuestionIndex + 1).arg(session.text(item.question)));
 
     for (int i = 0; i < 4; ++i) {
-        optionBoxes[i]->setText(options[i]);
+        optionBoxes[i]->setText(session.option(item.question, item.order[i]));
         optionBoxes[i]->setChecked(false);
     }
+
+    questionLimitMs = qint64(session.timeBudget(item.question, item.question + 1)) * 1000;
+    questionClock.start();
+    showRemainingTime();
 }
 
-void QuizTaker::submitAnswer()
+quint8 QuizTaker::checkedMask() const
 {
-    QSet<QString> selectedAnswers;
+    // Сервер сам переводит показанный порядок в исходные индексы
+    if (remote) {
+        quint8 shownMask = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (optionBoxes[i]->isChecked())
+                shownMask |= 1u << i;
+        }
+        return shownMask;
+    }
+
+    const SessionPlan::Item &item = plan.item(currentQuestionIndex);
+    quint8 answerMask = 0;
     for (int i = 0; i < 4; ++i) {
         if (optionBoxes[i]->isChecked())
-            selectedAnswers.insert(optionBoxes[i]->text());
+            answerMask |= 1u << item.order[i];
     }
+    return answerMask;
+}
 
-    if (selectedAnswers.isEmpty()) {
+void QuizTaker::submitAnswer()
+{
+    const quint8 answerMask = checkedMask();
+    if (answerMask == 0) {
         QMessageBox::warning(this, "Ошибка", "Выберите хотя бы один вариант!");
         return;
     }
-
-    if (selectedAnswers == currentCorrectAnswers) {
-        QJsonObject obj = quizData[currentQuestionIndex].toObject();
-        int difficulty = obj.value("difficulty").toInt(1);
-        score += difficulty;
+    if (remote) {
+        remote->sendAnswer(currentQuestionIndex, answerMask);
+        submitButton->setEnabled(false);
+        for (int i = 0; i < 4; ++i)
+            optionBoxes[i]->setEnabled(false);
+        return;
     }
+    recordAnswer(answerMask);
+}
+
+void QuizTaker::recordAnswer(quint8 answerMask)
+{
+    // Время от показа вопроса до ответа, в миллисекундах
+    responseTimes.append(int(questionClock.elapsed()));
+    const int question = plan.item(currentQuestionIndex).question;
+    score += session.points(question, answerMask);
+
+    ScoreRecord::Answer answer;
+    answer.question = question;
+    answer.mask = answerMask;
+    answer.key = session.correctMask(question);
+    answers.append(answer);
 
     currentQuestionIndex++;
+    if (plan.request().adaptive()) {
+        ability.update(itemParameters[question], answer.correct());
+        extendAdaptive();
+    }
     loadQuestion();
 }
 
 void QuizTaker::updateTimer()
 {
-    remainingTime = remainingTime.addSecs(-1);
-    timerLabel->setText(remainingTime.toString("mm:ss"));
+    // Вопрос по сроку закрывает сервер, здесь только надпись
+    if (remote) {
+        if (!submitButton->isEnabled())
+            return;
+        showRemainingTime();
+        if (remainingMs() <= 0) {
+            submitButton->setEnabled(false);
+            timerLabel->setText("Время вышло, ждём следующий вопрос…");
+        }
+        return;
+    }
+
+    if (perQuestionLimit()) {
+        // Пока ждём загрузки следующих вопросов, отсчитывать нечего
+        if (waitingForQuestions || currentQuestionIndex >= plan.count())
+            return;
+        showRemainingTime();
+        if (remainingMs() <= 0)
+            recordAnswer(checkedMask());
+        return;
+    }
 
-    if (remainingTime == QTime(0, 0, 0))
+    showRemainingTime();
+    if (remainingMs() <= 0)
         timeIsUp();
 }
 
@@ -197,8 +487,14 @@ void QuizTaker::timeIsUp()
 void QuizTaker::finishQuiz(bool)
 {
     quizTimer->stop();
-    QMessageBox::information(this, "Результат",
-                             QString("Вы набрали %1 балл(ов).").arg(score));
+    QString result = QString("Вы набрали %1 балл(ов).").arg(score);
+    if (plan.request().adaptive()) {
+        result += QString("\nОценка уровня: %1 ± %2 (вопросов: %3)")
+                      .arg(ability.theta(), 0, 'f', 2)
+                      .arg(ability.standardError(), 0, 'f', 2)
+                      .arg(ability.count());
+    }
+    QMessageBox::information(this, "Результат", result);
     askForNameAndSaveScore();
     showScoreTableOnly();
 }
@@ -211,57 +507,33 @@ void QuizTaker::askForNameAndSaveScore()
                                          QLineEdit::Normal, "", &ok);
 
     if (ok && !name.trimmed().isEmpty()) {
-        QFile file("scores.json");
-        QJsonArray scoresArray;
-
-        if (file.open(QIODevice::ReadOnly)) {
-            QByteArray data = file.readAll();
-            QJsonDocument doc = QJsonDocument::fromJson(data);
-            scoresArray = doc.array();
-            file.close();
+        ScoreRecord newRecord;
+        newRecord.name = name.trimmed();
+        newRecord.score = score;
+        newRecord.quiz = quizFileName;
+        newRecord.plan = plan.request().toJson();
+        newRecord.times = responseTimes;
+        newRecord.answers = answers;
+
+        ScoreStore *store = ScoreStore::instance();
+        const int recordId = store->add(newRecord);
+        if (recordId < 0) {
+            QMessageBox::critical(this, "Ошибка", "Не удалось сохранить результат.");
+            return;
         }
 
-        QJsonObject newRecord;
-        newRecord["name"] = name.trimmed();
-        newRecord["score"] = score;
-        newRecord["quiz"] = quizFileName;
-
-        scoresArray.append(newRecord);
-
-        if (file.open(QIODevice::WriteOnly)) {
-            QJsonDocument doc(scoresArray);
-            file.write(doc.toJson());
-            file.close();
-        }
+        scoreModel->setHighlightedRecord(recordId);
+        const LeaderboardIndex *board = store->leaderboard(quizFileName);
+        rankLabel->setText(QString("Ваше место: %1 из %2")
+                               .arg(board->rankOf(score))
+                               .arg(board->count()));
+        rankLabel->show();
     }
 }
 
 void QuizTaker::loadScoresToTable(const QString &filter)
 {
-    QFile file("scores.json");
-    if (!file.open(QIODevice::ReadOnly)) {
-        scoreTable->setRowCount(0);
-        return;
-    }
-
-    QJsonArray scoresArray = QJsonDocument::fromJson(file.readAll()).array();
-    QList<QJsonObject> records;
-
-    for (const QJsonValue &val : scoresArray) {
-        QJsonObject obj = val.toObject();
-        if (filter == "Все викторины" || obj["quiz"].toString() == filter)
-            records.append(obj);
-    }
-
-    std::sort(records.begin(), records.end(), [](const QJsonObject &a, const QJsonObject &b) {
-        return a["score"].toInt() > b["score"].toInt();
-    });
-
-    scoreTable->setRowCount(records.size());
-    for (int i = 0; i < records.size(); ++i) {
-        scoreTable->setItem(i, 0, new QTableWidgetItem(records[i]["name"].toString()));
-        scoreTable->setItem(i, 1, new QTableWidgetItem(QString::number(records[i]["score"].toInt())));
-    }
+    scoreModel->setQuiz(filter == "Все викторины" ? QString() : filter);
 }
 
 void QuizTaker::showScoreTableOnly()
@@ -274,6 +546,7 @@ void QuizTaker::showScoreTableOnly()
 
     loadScoresToTable("Все викторины");
 
+    layout->addWidget(rankLabel);
     layout->addWidget(scoreTable);
     scoreTable->show();
 
@@ -297,15 +570,11 @@ void QuizTaker::showScoreTableOnly()
         QComboBox *filterBox = new QComboBox(this);
         filterBox->addItem("Все викторины");
 
-        QFile file("scores.json");
-        if (file.open(QIODevice::ReadOnly)) {
-            QJsonArray arr = QJsonDocument::fromJson(file.readAll()).array();
-            QSet<QString> quizSet;
-            for (const QJsonValue &v : arr)
-                quizSet.insert(v.toObject()["quiz"].toString());
-            for (const QString &quiz : quizSet)
+        filterBox->addItems(ScoreStore::instance()->quizzes());
+        connect(ScoreStore::instance(), &ScoreStore::quizAdded, filterBox, [=](const QString &quiz) {
+            if (filterBox->findText(quiz) < 0)
                 filterBox->addItem(quiz);
-        }
+        });
 
         connect(filterBox, &QComboBox::currentTextChanged, this, [=](const QString &quizName) {
             loadScoresToTable(quizName);
@@ -339,6 +608,8 @@ void QuizTaker::restartQuiz()
         layout->removeWidget(scoreTable);
         scoreTable->hide();
     }
+    layout->removeWidget(rankLabel);
+    rankLabel->hide();
 
     questionLabel->show();
     for (int i = 0; i < 4; ++i)
@@ -349,19 +620,14 @@ void QuizTaker::restartQuiz()
     againButton->hide();
     exitButton->hide();
 
-    int totalSeconds = 0;
-    for (const QJsonValue &val : quizData) {
-        int difficulty = val.toObject().value("difficulty").toInt(1);
-        switch (difficulty) {
-        case 1: totalSeconds += 20; break;
-        case 2: totalSeconds += 35; break;
-        case 3: totalSeconds += 90; break;
-        default: totalSeconds += 35;
-        }
-    }
-    remainingTime = QTime(0, 0).addSecs(totalSeconds);
-    timerLabel->setText(remainingTime.toString("mm:ss"));
-    quizTimer->start(1000);
+    // Повторное прохождение — новый план с новым зерном
+    startPlan(SessionPlan::randomSeed());
+    responseTimes.clear();
+    answers.clear();
+    deadlineMs = 0;
+    addPlanTime(0, plan.count());
+    quizTimer->stop();
+    startClock();
 
     loadQuestion();
 }
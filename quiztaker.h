@@ -10,24 +10,60 @@
 #include <QJsonArray>
 #include <QTimer>
 #include <QTime>
-#include <QTableWidget>
+#include <QElapsedTimer>
+#include <QTableView>
 #include <QHBoxLayout>
 #include <QComboBox>
+#include <QProgressBar>
+#include <QVector>
+
+#include "quizsource.h"
+#include "compiledquiz.h"
+#include "sessionplan.h"
+#include "irtmodel.h"
+#include "adaptiveselector.h"
+#include "scorestore.h"
+
+class ScoreTableModel;
+class SessionClient;
 
 class QuizTaker : public QWidget {
     Q_OBJECT
 
 public:
-    explicit QuizTaker(const QString &fileName, QWidget *parent = nullptr);
+    explicit QuizTaker(const QString &fileName,
+                       const SessionPlan::Request &request = SessionPlan::Request::sequential(),
+                       QWidget *parent = nullptr);
+    // Участие в сессии класса; окно становится владельцем клиента
+    explicit QuizTaker(SessionClient *client, QWidget *parent = nullptr);
 
 private slots:
     void submitAnswer();
     void updateTimer();
     void timeIsUp();
     void restartQuiz();
+    void onQuestionsLoaded(const QVector<Question> &batch);
+    void onLoadFinished(int count, bool cancelled);
+    void showRemoteQuestion(int position, int total, const QString &text,
+                            const QStringList &options, int difficulty, int remaining);
+    void finishRemote(int finalScore, int rank, int participants);
 
 private:
+    void buildLayout();
     void loadQuestion();
+    void startLoading(const QString &fileName);
+    void addQuestions(int first, int last);
+    void addPlanTime(int first, int last);
+    void startPlan(quint64 seed);
+    bool needsWholeBank() const;
+    void planWholeBank();
+    void extendAdaptive();
+    bool perQuestionLimit() const;
+    void startClock();
+    qint64 remainingMs() const;
+    void showRemainingTime();
+    quint8 checkedMask() const;
+    void recordAnswer(quint8 answerMask);
     void finishQuiz(bool timeUp = false);
     void askForNameAndSaveScore();
     void loadScoresToTable(const QString &filter = "Все викторины");
@@ -36,26 +72,49 @@ private:
     bool filterAdded = false;
 
     QHBoxLayout* filterLayout = nullptr;
-    QTableWidget *scoreTable;
+    QTableView *scoreTable;
+    ScoreTableModel *scoreModel;
+    QLabel *rankLabel;
     QPushButton  *againButton;
     QPushButton  *exitButton;
 
     QLabel *questionLabel;
     QCheckBox *optionBoxes[4];
-    QSet<QString> currentCorrectAnswers;
     QPushButton *submitButton;
 
     QVBoxLayout *layout;
 
-    QJsonArray quizData;
+    QuizSource quizData;
+    CompiledQuiz session;
+    DifficultyIndex difficultyIndex;
+    SessionPlan plan;
+    bool loadingFinished = false;
+    bool waitingForQuestions = false;
+    QProgressBar *loadProgress;
     int currentQuestionIndex;
     int score;
 
+    // Отсчёт ведётся от монотонных часов, таймер только обновляет надпись
     QTimer *quizTimer;
-    QTime remainingTime;
+    QElapsedTimer sessionClock;
+    qint64 deadlineMs = 0;
+    QElapsedTimer questionClock;
+    qint64 questionLimitMs = 0;
+    QVector<int> responseTimes;
+    QVector<ScoreRecord::Answer> answers;
     QLabel *timerLabel;
 
     QString quizFileName;
+    QString quizPath;
+
+    // Адаптивный тест: параметры вопросов, индекс выбора и текущая оценка уровня
+    QVector<ItemParameters> itemParameters;
+    AdaptiveSelector selector;
+    AbilityEstimate ability;
+
+    SessionClient *remote = nullptr;
+    QLabel *standingsLabel = nullptr;
+    bool remoteFinished = false;
 };
 
 #endif // QUIZTAKER_H
@@ -1,50 +1,58 @@
 #include "quizviewer.h"
 #include "quiztaker.h"
+#include "quizsource.h"
+#include "quizloader.h"
+#include "questionmodel.h"
+#include "quizdeltalog.h"
+#include "scorestore.h"
 
 #include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QFileInfo>
 #include <QMessageBox>
-#include <QListWidgetItem>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QElapsedTimer>
+#include <QKeySequence>
 #include <QDebug>
+#include <cmath>
+
+namespace {
+const int kConsolidateEvery = 64;
+const int kConsolidateIntervalMs = 30000;
+const int kMaxUndoSteps = 10000;
+}
 
 QuizViewer::QuizViewer(const QString &fileName, QWidget *mainWindow)
     : QWidget(nullptr), mainWindowPtr(mainWindow), loadedFileName(fileName)
 {
-    this->setStyleSheet(R"(
-        QWidget {
-            background-color: #ffe4f0;
-            font-family: "Segoe UI", sans-serif;
-            font-size: 16px;
-        }
-        QListWidget {
-            background-color: #fff0f8;
-            border: 1px solid #ffaad4;
-            border-radius: 6px;
-        }
-        QLineEdit, QComboBox {
-            background-color: white;
-            padding: 6px;
-            border-radius: 6px;
-        }
-        QPushButton {
-            background-color: #ffaad4;
-            border: 2px solid white;
-            border-radius: 10px;
-            color: white;
-            font-weight: bold;
-            padding: 8px 16px;
-        }
-        QPushButton:hover {
-            background-color: #ff8fb6;
-        }
-    )");
-
     auto *mainLayout = new QVBoxLayout(this);
 
-    listWidget = new QListWidget(this);
+    // Поиск по мере ввода: только запрос к индексу, текст вопросов не перебирается
+    auto *searchRow = new QHBoxLayout;
+    searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText("Поиск по вопросам и вариантам");
+    searchEdit->setClearButtonEnabled(true);
+    searchStatus = new QLabel(this);
+    searchRow->addWidget(searchEdit);
+    searchRow->addWidget(searchStatus);
+    mainLayout->addLayout(searchRow);
+
+    quizData = new QuestionModel(QuestionModel::TitleOnly, this);
+    listWidget = new QListView(this);
+    listWidget->setModel(quizData);
+    listWidget->setUniformItemSizes(true);
     mainLayout->addWidget(listWidget);
 
+    auto *loadRow = new QHBoxLayout;
+    loadProgress = new QProgressBar(this);
+    cancelLoadButton = new QPushButton("Отмена", this);
+    loadRow->addWidget(loadProgress);
+    loadRow->addWidget(cancelLoadButton);
+    mainLayout->addLayout(loadRow);
+
     // Элементы редактирования
     questionEdit = new QLineEdit(this);
     mainLayout->addWidget(new QLabel("Вопрос:", this));
@@ -53,11 +61,14 @@ QuizViewer::QuizViewer(const QString &fileName, QWidget *mainWindow)
     for (int i = 0; i < 4; ++i) {
         answerEdits[i] = new QLineEdit(this);
         correctBoxes[i] = new QCheckBox("Правильный", this);
+        optionRateLabels[i] = new QLabel(this);
+        optionRateLabels[i]->setMinimumWidth(40);
 
         auto *row = new QHBoxLayout;
         row->addWidget(new QLabel(QString("Вариант %1:").arg(i + 1), this));
         row->addWidget(answerEdits[i]);
         row->addWidget(correctBoxes[i]);
+        row->addWidget(optionRateLabels[i]);
 
         mainLayout->addLayout(row);
     }
@@ -67,109 +78,417 @@ QuizViewer::QuizViewer(const QString &fileName, QWidget *mainWindow)
     mainLayout->addWidget(new QLabel("Сложность:", this));
     mainLayout->addWidget(difficultyBox);
 
+    statsLabel = new QLabel(this);
+    statsLabel->setWordWrap(true);
+    mainLayout->addWidget(statsLabel);
+
     // Кнопки
     auto *btnRow = new QHBoxLayout;
     saveButton = new QPushButton("Сохранить изменения", this);
     startButton = new QPushButton("Начать викторину", this);
+    sampleButton = new QPushButton("Случайная выборка…", this);
+    sampleButton->setEnabled(false);
+    adaptiveButton = new QPushButton("Адаптивный тест…", this);
+    adaptiveButton->setEnabled(false);
+    undoButton = new QPushButton("Отменить", this);
+    undoButton->setShortcut(QKeySequence::Undo);
+    redoButton = new QPushButton("Повторить", this);
+    redoButton->setShortcut(QKeySequence::Redo);
     btnRow->addWidget(saveButton);
+    btnRow->addWidget(undoButton);
+    btnRow->addWidget(redoButton);
     btnRow->addWidget(startButton);
+    btnRow->addWidget(sampleButton);
+    btnRow->addWidget(adaptiveButton);
     mainLayout->addLayout(btnRow);
 
+    perQuestionBox = new QCheckBox("Ограничить время на каждый вопрос", this);
+    mainLayout->addWidget(perQuestionBox);
+
     connect(saveButton, &QPushButton::clicked, this, &QuizViewer::saveCurrentQuestion);
+    connect(undoButton, &QPushButton::clicked, this, &QuizViewer::undo);
+    connect(redoButton, &QPushButton::clicked, this, &QuizViewer::redo);
     connect(startButton, &QPushButton::clicked, this, &QuizViewer::startQuiz);
-    connect(listWidget, &QListWidget::itemClicked, this, &QuizViewer::onQuestionSelected);
+    connect(sampleButton, &QPushButton::clicked, this, &QuizViewer::startSampledQuiz);
+    connect(adaptiveButton, &QPushButton::clicked, this, &QuizViewer::startAdaptiveQuiz);
+    connect(listWidget, &QListView::clicked, this, &QuizViewer::onQuestionSelected);
+    connect(searchEdit, &QLineEdit::textChanged, this, &QuizViewer::applySearch);
+    connect(cancelLoadButton, &QPushButton::clicked, this, [this]() {
+        if (loader)
+            loader->cancel();
+    });
+
+    // Полная перезапись файла — не чаще раза в полминуты или 64 правки
+    consolidateTimer = new QTimer(this);
+    consolidateTimer->setSingleShot(true);
+    consolidateTimer->setInterval(kConsolidateIntervalMs);
+    connect(consolidateTimer, &QTimer::timeout, this, &QuizViewer::saveToOriginalFile);
 
     loadQuizFile(fileName);
 }
 
+void QuizViewer::closeEvent(QCloseEvent *event)
+{
+    if (deltaLog) {
+        if (deltaLog->pendingCount() > 0)
+            saveToOriginalFile();
+        deltaLog->waitForIdle();
+    }
+    QWidget::closeEvent(event);
+}
+
 void QuizViewer::loadQuizFile(const QString &fileName)
 {
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::critical(this, "Ошибка", "Не удалось открыть файл викторины.");
+    searchEdit->clear();
+    quizData->clear();
+    searchIndex.clear();
+    undoSteps.clear();
+    undoPosition = 0;
+    updateUndoButtons();
+    loadComplete = false;
+    loadFailed = false;
+    saveButton->setEnabled(false);
+    loadProgress->setRange(0, 0);
+    loadProgress->show();
+    cancelLoadButton->show();
+
+    // Файл разбирается в рабочем потоке, вопросы добавляются по мере разбора
+    delete loader;
+    loader = new QuizLoader(fileName, this);
+    connect(loader, &QuizLoader::questionsLoaded, this, &QuizViewer::onQuestionsLoaded);
+    connect(loader, &QuizLoader::progress, this, [this](qint64 done, qint64 total) {
+        loadProgress->setRange(0, 1000);
+        loadProgress->setValue(total > 0 ? int(done * 1000 / total) : 1000);
+    });
+    connect(loader, &QuizLoader::failed, this, [this](qint64 offset, const QString &message) {
+        loadFailed = true;
+        QMessageBox::critical(this, "Ошибка",
+                              QString("Ошибка в файле викторины (байт %1): %2\n"
+                                      "Загружено вопросов: %3. Сохранение отключено.")
+                                  .arg(offset).arg(message).arg(quizData->count()));
+    });
+    connect(loader, &QuizLoader::finished, this, &QuizViewer::onLoadFinished);
+    loader->start();
+}
+
+void QuizViewer::onQuestionsLoaded(const QVector<Question> &batch)
+{
+    const int first = quizData->count();
+    for (int i = 0; i < batch.size(); ++i)
+        searchIndex.add(first + i, batch[i]);
+    quizData->append(batch);
+}
+
+void QuizViewer::replaceQuestion(int index, const Question &question)
+{
+    if (index < 0 || index >= quizData->count())
+        return;
+    searchIndex.update(index, quizData->question(index), question);
+    quizData->setQuestion(index, question);
+}
+
+void QuizViewer::applySearch(const QString &query)
+{
+    if (SearchIndex::tokenize(query).isEmpty()) {
+        quizData->clearRowFilter();
+        searchStatus->clear();
         return;
     }
 
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    quizData = doc.array();
+    QElapsedTimer timer;
+    timer.start();
+    quizData->setRowFilter(searchIndex.search(query));
+    searchStatus->setText(QString("Найдено: %1 (%2 мс)")
+                              .arg(quizData->rowCount())
+                              .arg(timer.nsecsElapsed() / 1e6, 0, 'f', 1));
+}
 
-    listWidget->clear();
-    for (const QJsonValue &value : quizData) {
-        QJsonObject obj = value.toObject();
-        listWidget->addItem(obj["question"].toString());
+void QuizViewer::onLoadFinished(int count, bool cancelled)
+{
+    loadProgress->hide();
+    cancelLoadButton->hide();
+
+    // Сохранять частично загруженный банк нельзя — он перезапишет файл целиком
+    loadComplete = !cancelled && !loadFailed && count == quizData->count();
+    saveButton->setEnabled(loadComplete);
+    sampleButton->setEnabled(loadComplete);
+    adaptiveButton->setEnabled(loadComplete);
+    if (!loadComplete) {
+        saveButton->setToolTip("Викторина загружена не полностью");
+        return;
     }
+
+    // Правки, не успевшие попасть в файл до сбоя, применяются поверх него
+    const QHash<int, Question> deltas = QuizDeltaLog::read(loadedFileName);
+    for (auto it = deltas.constBegin(); it != deltas.constEnd(); ++it)
+        replaceQuestion(it.key(), it.value());
+
+    deltaLog = new QuizDeltaLog(loadedFileName, this);
+    connect(deltaLog, &QuizDeltaLog::failed, this, [this](const QString &message) {
+        QMessageBox::critical(this, "Ошибка", message);
+    });
+    if (!deltas.isEmpty())
+        saveToOriginalFile();
 }
 
-void QuizViewer::onQuestionSelected(QListWidgetItem *item)
+void QuizViewer::onQuestionSelected(const QModelIndex &modelIndex)
 {
-    int index = listWidget->row(item);
-    if (index < 0 || index >= quizData.size()) return;
+    if (!modelIndex.isValid()) return;
+    showQuestion(quizData->sourceRow(modelIndex.row()));
+}
 
-    currentEditingIndex = index;
-    QJsonObject obj = quizData[index].toObject();
+void QuizViewer::showQuestion(int index)
+{
+    if (index < 0 || index >= quizData->count()) return;
 
-    questionEdit->setText(obj["question"].toString());
+    currentEditingIndex = index;
+    const Question &q = quizData->question(index);
 
-    QJsonArray options = obj["options"].toArray();
-    for (int i = 0; i < 4; ++i)
-        answerEdits[i]->setText(options[i].toString());
+    questionEdit->setText(q.text);
 
-    QJsonArray correct = obj["correct"].toArray();
-    for (int i = 0; i < 4; ++i)
-        correctBoxes[i]->setChecked(false);
-    for (const QJsonValue &val : correct)
-        if (val.isDouble())
-            correctBoxes[val.toInt()]->setChecked(true);
+    for (int i = 0; i < 4; ++i) {
+        answerEdits[i]->setText(q.options[i]);
+        correctBoxes[i]->setChecked(q.isCorrect(i));
+    }
 
-    difficultyBox->setCurrentIndex(obj["difficulty"].toInt(1) - 1);
+    difficultyBox->setCurrentIndex(q.difficulty - 1);
+    showItemStats();
 }
 
-void QuizViewer::saveCurrentQuestion()
+// Статистика из общего кэша результатов: он обновляется по мере появления
+// новых записей, здесь только чтение готовых сумм выбранного вопроса
+void QuizViewer::showItemStats()
 {
-    if (currentEditingIndex < 0 || currentEditingIndex >= quizData.size()) return;
+    ScoreStore *store = ScoreStore::instance();
+    if (!statsConnected) {
+        connect(store, &ScoreStore::recordsAdded, this, &QuizViewer::showItemStats);
+        connect(store, &ScoreStore::reloaded, this, &QuizViewer::showItemStats);
+        statsConnected = true;
+    }
 
-    QJsonObject obj;
-    obj["question"] = questionEdit->text();
+    const ItemStats *stats = store->itemStats(QFileInfo(loadedFileName).fileName(), quizData->count());
+    const ItemStats::Item *item = stats ? stats->item(currentEditingIndex) : nullptr;
+    // Ответы с другим ключом относятся к прежней редакции вопроса и не показываются
+    if (item && item->key != quizData->question(currentEditingIndex).correctMask)
+        item = nullptr;
+    if (!item) {
+        statsLabel->setText("Статистика: ответов на этот вопрос с текущими правильными вариантами ещё нет");
+        for (int i = 0; i < 4; ++i) {
+            optionRateLabels[i]->clear();
+            optionRateLabels[i]->setToolTip(QString());
+        }
+        return;
+    }
 
-    QJsonArray options;
-    for (int i = 0; i < 4; ++i)
-        options.append(answerEdits[i]->text());
-    obj["options"] = options;
+    for (int i = 0; i < 4; ++i) {
+        optionRateLabels[i]->setText(QString("%1%").arg(item->optionRate(i), 0, 'f', 0));
+        optionRateLabels[i]->setToolTip(QString("Выбрали %1 из %2").arg(item->chosen[i]).arg(item->attempts));
+    }
+
+    const double discrimination = item->discrimination();
+    QString text = QString("Статистика: ответов %1, верных %2%, без ответа %3, среднее время %4 с, "
+                           "различающая способность %5")
+                       .arg(item->attempts)
+                       .arg(item->percentCorrect(), 0, 'f', 1)
+                       .arg(item->blank)
+                       .arg(item->meanTimeMs() / 1000.0, 0, 'f', 1)
+                       .arg(std::isnan(discrimination) ? QString("—") : QString::number(discrimination, 'f', 2));
+
+    // Подсказки к разбору: отрицательная связь с остальными ответами часто означает неверный ключ
+    if (!std::isnan(discrimination) && discrimination < 0)
+        text += "\nСильные участники ошибаются здесь чаще слабых — проверьте правильные варианты.";
+    else if (!std::isnan(discrimination) && discrimination < 0.2)
+        text += "\nВопрос слабо различает подготовленных и неподготовленных.";
+    if (item->percentCorrect() > 95.0)
+        text += "\nПочти все отвечают верно — вопрос слишком лёгкий.";
+    statsLabel->setText(text);
+}
 
-    QJsonArray correct;
-    for (int i = 0; i < 4; ++i)
+void QuizViewer::saveCurrentQuestion()
+{
+    if (currentEditingIndex < 0 || currentEditingIndex >= quizData->count()) return;
+
+    Question q;
+    q.text = questionEdit->text();
+    for (int i = 0; i < 4; ++i) {
+        q.options[i] = answerEdits[i]->text();
         if (correctBoxes[i]->isChecked())
-            correct.append(i);
-    obj["correct"] = correct;
+            q.correctMask |= 1u << i;
+    }
+    q.difficulty = static_cast<quint8>(difficultyBox->currentIndex() + 1);
 
-    obj["difficulty"] = difficultyBox->currentIndex() + 1;
+    const PersistentQuestions before = quizData->questions();
+    replaceQuestion(currentEditingIndex, q);
 
-    quizData[currentEditingIndex] = obj;
-    listWidget->item(currentEditingIndex)->setText(obj["question"].toString());
+    undoSteps.resize(undoPosition);
+    if (undoSteps.size() == kMaxUndoSteps)
+        undoSteps.removeFirst();
+    undoSteps.append({currentEditingIndex, before, quizData->questions()});
+    undoPosition = undoSteps.size();
+    updateUndoButtons();
 
-    saveToOriginalFile();
+    persistEdit(currentEditingIndex, q);
     QMessageBox::information(this, "Успех", "Вопрос успешно обновлён и сохранён.");
 }
 
-void QuizViewer::saveToOriginalFile()
+void QuizViewer::persistEdit(int index, const Question &question)
+{
+    deltaLog->record(index, question);
+    if (deltaLog->pendingCount() >= kConsolidateEvery)
+        saveToOriginalFile();
+    else if (!consolidateTimer->isActive())
+        consolidateTimer->start();
+}
+
+void QuizViewer::undo()
 {
-    QFile file(loadedFileName);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::critical(this, "Ошибка", "Не удалось сохранить файл.");
+    if (undoPosition == 0 || !deltaLog)
         return;
-    }
+    const UndoStep &step = undoSteps[--undoPosition];
+    switchVersion(step.before, step.index);
+}
 
-    QJsonDocument doc(quizData);
-    file.write(doc.toJson());
-    file.close();
+void QuizViewer::redo()
+{
+    if (undoPosition == undoSteps.size() || !deltaLog)
+        return;
+    const UndoStep &step = undoSteps[undoPosition++];
+    switchVersion(step.after, step.index);
+}
+
+void QuizViewer::switchVersion(const PersistentQuestions &version, int index)
+{
+    // Переключение — замена корня; версии отличаются только вопросом index,
+    // поэтому индекс поиска и журнал правок обновляются только для него
+    const Question target = version.at(index);
+    searchIndex.update(index, quizData->question(index), target);
+    quizData->restore(version, index);
+    persistEdit(index, target);
+
+    if (currentEditingIndex == index)
+        showQuestion(index);
+    updateUndoButtons();
+}
+
+void QuizViewer::updateUndoButtons()
+{
+    undoButton->setEnabled(loadComplete && undoPosition > 0);
+    redoButton->setEnabled(loadComplete && undoPosition < undoSteps.size());
+}
+
+void QuizViewer::saveToOriginalFile()
+{
+    consolidateTimer->stop();
+    if (deltaLog)
+        deltaLog->consolidate(quizData->questions());
 }
 
 void QuizViewer::startQuiz()
 {
-    auto *quizTaker = new QuizTaker(loadedFileName);
+    launchQuiz(SessionPlan::Request::sequential());
+}
+
+void QuizViewer::startSampledQuiz()
+{
+    int available[DifficultyIndex::kLevels] = {0, 0, 0};
+    for (int i = 0; i < quizData->count(); ++i) {
+        const int difficulty = quizData->question(i).difficulty;
+        ++available[difficulty >= 1 && difficulty <= 3 ? difficulty - 1 : 1];
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Случайная выборка вопросов");
+    auto *form = new QFormLayout(&dialog);
+
+    QSpinBox *countBoxes[DifficultyIndex::kLevels];
+    for (int level = 0; level < DifficultyIndex::kLevels; ++level) {
+        countBoxes[level] = new QSpinBox(&dialog);
+        countBoxes[level]->setRange(0, available[level]);
+        countBoxes[level]->setValue(qMin(available[level], 10));
+        form->addRow(QString("%1 (из %2):").arg(Question::difficultyName(level + 1)).arg(available[level]),
+                     countBoxes[level]);
+    }
+
+    // Пустое зерно — случайное; введённое зерно воспроизводит ту же сессию
+    auto *seedEdit = new QLineEdit(&dialog);
+    seedEdit->setPlaceholderText("случайное");
+    form->addRow("Зерно:", seedEdit);
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    form->addRow(buttons);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    SessionPlan::Request request;
+    bool seedOk = false;
+    request.seed = seedEdit->text().trimmed().toULongLong(&seedOk);
+    if (!seedOk)
+        request.seed = SessionPlan::randomSeed();
+    request.sampled = true;
+    for (int level = 0; level < DifficultyIndex::kLevels; ++level)
+        request.counts[level] = countBoxes[level]->value();
+
+    launchQuiz(request);
+}
+
+// Вопросы подбираются по ходу под текущую оценку уровня; параметры вопросов
+// берутся из "<файл>.irt" (QuizCli calibrate), без него — по полю сложности
+void QuizViewer::startAdaptiveQuiz()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Адаптивный тест");
+    auto *form = new QFormLayout(&dialog);
+
+    auto *lengthBox = new QSpinBox(&dialog);
+    lengthBox->setRange(1, qMax(1, quizData->count()));
+    lengthBox->setValue(qMin(quizData->count(), 20));
+    form->addRow("Наибольшее число вопросов:", lengthBox);
+
+    auto *errorBox = new QDoubleSpinBox(&dialog);
+    errorBox->setRange(0.0, 1.0);
+    errorBox->setSingleStep(0.05);
+    errorBox->setValue(0.3);
+    errorBox->setSpecialValueText("до конца");
+    form->addRow("Закончить при погрешности уровня:", errorBox);
+
+    auto *seedEdit = new QLineEdit(&dialog);
+    seedEdit->setPlaceholderText("случайное");
+    form->addRow("Зерно:", seedEdit);
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    form->addRow(buttons);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    SessionPlan::Request request;
+    bool seedOk = false;
+    request.seed = seedEdit->text().trimmed().toULongLong(&seedOk);
+    if (!seedOk)
+        request.seed = SessionPlan::randomSeed();
+    request.adaptiveLength = lengthBox->value();
+    request.targetError = errorBox->value();
+
+    launchQuiz(request);
+}
+
+void QuizViewer::launchQuiz(SessionPlan::Request request)
+{
+    request.perQuestionLimit = perQuestionBox->isChecked() || request.adaptive();
+
+    if (deltaLog) {
+        saveToOriginalFile();
+        deltaLog->waitForIdle();
+    }
+
+    auto *quizTaker = new QuizTaker(loadedFileName, request);
     quizTaker->setAttribute(Qt::WA_DeleteOnClose);
-    quizTaker->setWindowTitle("Прохождение викторины");
+    quizTaker->setWindowTitle(QString("Прохождение викторины (зерно %1)").arg(request.seed));
     quizTaker->resize(800, 600);
     quizTaker->show();
 
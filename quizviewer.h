@@ -3,15 +3,26 @@
 
 #include <QWidget>
 #include <QString>
-#include <QListWidget>
+#include <QListView>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QJsonArray>
 #include <QLineEdit>
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QProgressBar>
+#include <QTimer>
+#include <QCloseEvent>
+
+#include "question.h"
+#include "sessionplan.h"
+#include "searchindex.h"
+#include "persistentquestions.h"
+
+class QuizLoader;
+class QuestionModel;
+class QuizDeltaLog;
 
 class QuizViewer : public QWidget
 {
@@ -20,29 +31,76 @@ class QuizViewer : public QWidget
 public:
     explicit QuizViewer(const QString &fileName, QWidget *mainWindow = nullptr);
 
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private slots:
     void startQuiz();
-    void onQuestionSelected(QListWidgetItem *item);
+    void startSampledQuiz();
+    void startAdaptiveQuiz();
+    void onQuestionSelected(const QModelIndex &index);
     void saveCurrentQuestion();
+    void undo();
+    void redo();
 
 private:
     void loadQuizFile(const QString &fileName);
     void saveToOriginalFile();
+    void launchQuiz(SessionPlan::Request request);
+    void replaceQuestion(int index, const Question &question);
+    void showQuestion(int index);
+    void persistEdit(int index, const Question &question);
+    void switchVersion(const PersistentQuestions &version, int index);
+    void updateUndoButtons();
+    void showItemStats();
+    void applySearch(const QString &query);
+    void onQuestionsLoaded(const QVector<Question> &batch);
+    void onLoadFinished(int count, bool cancelled);
 
     QWidget *mainWindowPtr;
     QString loadedFileName;
-    QJsonArray quizData;
+    QuestionModel *quizData;
 
-    QListWidget *listWidget;
+    QuizLoader *loader = nullptr;
+    QuizDeltaLog *deltaLog = nullptr;
+    QTimer *consolidateTimer;
+    bool loadComplete = false;
+    bool loadFailed = false;
+    QProgressBar *loadProgress;
+    QPushButton *cancelLoadButton;
+
+    QLineEdit *searchEdit;
+    QLabel *searchStatus;
+    SearchIndex searchIndex;
+    QListView *listWidget;
     QPushButton *startButton;
+    QPushButton *sampleButton;
+    QPushButton *adaptiveButton;
+    QCheckBox *perQuestionBox;
     QPushButton *saveButton;
+    QPushButton *undoButton;
+    QPushButton *redoButton;
 
     QLineEdit *questionEdit;
     QLineEdit *answerEdits[4];
     QCheckBox *correctBoxes[4];
     QComboBox *difficultyBox;
+    QLabel *optionRateLabels[4];
+    QLabel *statsLabel;
+    bool statsConnected = false;
 
     int currentEditingIndex = -1;
+
+    // История правок: версии банка до и после каждой правки. Версии делят
+    // между собой все узлы, кроме пути к изменённому вопросу.
+    struct UndoStep
+    {
+        int index;
+        PersistentQuestions before;
+        PersistentQuestions after;
+    };
+    QVector<UndoStep> undoSteps;
+    int undoPosition = 0;
 };
 
 #endif // QUIZVIEWER_H
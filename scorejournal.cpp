@@ -0,0 +1,515 @@
+#include "scorejournal.h"
+#include "journalline.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QLockFile>
+#include <QCoreApplication>
+#include <QSysInfo>
+#include <QDateTime>
+#include <QAtomicInt>
+#include <algorithm>
+
+namespace {
+
+const qint64 kSegmentLimit = 1024 * 1024;
+const int kCompactThreshold = 4;
+const int kLockTimeoutMs = 10000;
+const qint64 kStaleReceiptSecs = 600;
+const char kLegacyReceipt[] = "legacy.done";
+
+QMutex &compactionMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+// "segment-00000012.log" -> 12
+int fileNumber(const QString &name)
+{
+    const int dash = name.lastIndexOf('-');
+    const int dot = name.lastIndexOf('.');
+    return name.mid(dash + 1, dot - dash - 1).toInt();
+}
+
+QList<int> numbersOf(const QString &dirPath, const QString &pattern)
+{
+    QList<int> numbers;
+    const QStringList names = QDir(dirPath).entryList({pattern}, QDir::Files);
+    for (const QString &name : names)
+        numbers.append(fileNumber(name));
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+} // namespace
+
+ScoreJournal::ScoreJournal(const QString &dirPath)
+    : dirPath(dirPath)
+    , lockTimeoutMs(kLockTimeoutMs)
+{
+    QDir().mkpath(pendingPath());
+    migrateLegacyFile();
+}
+
+QString ScoreJournal::defaultPath()
+{
+    return "scores.d";
+}
+
+QString ScoreJournal::legacyFilePath() const
+{
+    // Старый файл лежит рядом с каталогом журнала
+    return QFileInfo(dirPath).dir().filePath("scores.json");
+}
+
+QString ScoreJournal::pendingPath() const
+{
+    return dirPath + "/pending";
+}
+
+QString ScoreJournal::lockPath() const
+{
+    return dirPath + "/journal.lock";
+}
+
+QString ScoreJournal::segmentPath(int number) const
+{
+    return QString("%1/segment-%2.log").arg(dirPath).arg(number, 8, 10, QChar('0'));
+}
+
+QString ScoreJournal::snapshotPath(int number) const
+{
+    return QString("%1/snapshot-%2.log").arg(dirPath).arg(number, 8, 10, QChar('0'));
+}
+
+int ScoreJournal::latestSnapshot() const
+{
+    const QList<int> snapshots = numbersOf(dirPath, "snapshot-*.log");
+    return snapshots.isEmpty() ? -1 : snapshots.last();
+}
+
+QList<int> ScoreJournal::segmentNumbers() const
+{
+    // Сегменты, уже свёрнутые в снимок, игнорируются (могли остаться после сбоя)
+    const int folded = latestSnapshot();
+    QList<int> segments;
+    for (int number : numbersOf(dirPath, "segment-*.log")) {
+        if (number > folded)
+            segments.append(number);
+    }
+    return segments;
+}
+
+void ScoreJournal::readFile(const QString &filePath, QList<QJsonObject> *records)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    // Оборванные при сбое или повреждённые строки пропускаются
+    while (!file.atEnd()) {
+        QJsonObject record;
+        if (JournalLine::decode(file.readLine(), &record))
+            records->append(record);
+    }
+}
+
+bool ScoreJournal::append(const QJsonObject &record, Position *position)
+{
+    return appendBatch(JournalLine::encode(record), position);
+}
+
+bool ScoreJournal::appendBatch(const QByteArray &lines, Position *position)
+{
+    // Сначала запись попадает в очередь pending/. Процесс, захвативший
+    // блокировку, дописывает в сегмент все накопившиеся записи всех процессов
+    // одним вызовом fsync и оставляет каждому автору квитанцию с позицией.
+    static QAtomicInt counter;
+    const QString base = QString("%1/%2-%3-%4-%5")
+                             .arg(pendingPath())
+                             .arg(QDateTime::currentMSecsSinceEpoch())
+                             .arg(qHash(QSysInfo::machineHostName()))
+                             .arg(QCoreApplication::applicationPid())
+                             .arg(counter.fetchAndAddRelaxed(1));
+
+    QFile staged(base + ".tmp");
+    if (!staged.open(QIODevice::WriteOnly) || staged.write(lines) != lines.size())
+        return false;
+    staged.close();
+    if (!QFile::rename(base + ".tmp", base + ".rec"))
+        return false;
+
+    QLockFile lock(lockPath());
+    if (!lock.tryLock(lockTimeoutMs)) {
+        // Пока запись не забрал фиксирующий процесс, её можно отозвать: тогда
+        // в журнал она не попадёт и повтор вызова не создаст дубликат
+        if (QFile::rename(base + ".rec", base + ".tmp")) {
+            QFile::remove(base + ".tmp");
+            return false;
+        }
+        // Запись уже в пакете владельца блокировки — дожидаемся квитанции
+        if (!lock.lock())
+            return false;
+    }
+
+    // .claimed остаётся, если фиксирующий процесс упал до записи пакета
+    const bool queued = QFile::exists(base + ".rec") || QFile::exists(base + ".claimed");
+    if (queued && !commitPending()) {
+        // Пакет не записан: своя запись снимается, чтобы повтор не задвоил её
+        QFile::remove(base + ".rec");
+        QFile::remove(base + ".claimed");
+        return false;
+    }
+
+    QFile receipt(base + ".done");
+    if (!receipt.open(QIODevice::ReadOnly))
+        return false;
+    const QList<QByteArray> fields = receipt.readAll().split(' ');
+    receipt.close();
+    receipt.remove();
+
+    if (position && fields.size() == 2) {
+        position->segment = fields[0].toInt();
+        position->offset = fields[1].toLongLong();
+    }
+    return true;
+}
+
+QString ScoreJournal::intentPath() const
+{
+    return pendingPath() + "/batch.intent";
+}
+
+void ScoreJournal::finishBatch(int segment, const QList<QPair<QString, qint64>> &receipts)
+{
+    for (const auto &receipt : receipts) {
+        QFile done(receipt.first + ".done");
+        if (done.open(QIODevice::WriteOnly)) {
+            done.write(QByteArray::number(segment) + ' ' + QByteArray::number(receipt.second));
+            done.close();
+        }
+        QFile::remove(receipt.first + ".claimed");
+    }
+    QFile::remove(intentPath());
+}
+
+bool ScoreJournal::recoverBatch()
+{
+    // Перед записью пакета фиксирующий процесс сохраняет его границы и состав
+    // (batch.intent). Если файл остался, процесс упал посреди фиксации: пакет
+    // либо уже целиком на диске — тогда остаётся выдать квитанции, либо его
+    // хвост отрезается и забранные записи фиксируются заново. Так упавшая
+    // фиксация не задваивает записи и не теряет их.
+    QFile intent(intentPath());
+    if (!intent.exists())
+        return true;
+    if (!intent.open(QIODevice::ReadOnly))
+        return false;
+
+    const QList<QByteArray> header = intent.readLine().trimmed().split(' ');
+    QList<QPair<QString, qint64>> receipts;
+    while (!intent.atEnd()) {
+        const QByteArray line = intent.readLine().trimmed();
+        const int space = line.indexOf(' ');
+        if (space > 0)
+            receipts.append({pendingPath() + "/" + QString::fromUtf8(line.mid(space + 1)), line.left(space).toLongLong()});
+    }
+    intent.close();
+    if (header.size() != 3) {
+        intent.remove();
+        return true;
+    }
+
+    const int segment = header[0].toInt();
+    const qint64 start = header[1].toLongLong();
+    const qint64 end = header[2].toLongLong();
+    QFile file(segmentPath(segment));
+    if (file.size() >= end) {
+        finishBatch(segment, receipts);
+        return true;
+    }
+    if (file.exists() && file.size() > start && !file.resize(start))
+        return false;
+    return intent.remove();
+}
+
+bool ScoreJournal::commitPending()
+{
+    if (!recoverBatch())
+        return false;
+
+    QDir pending(pendingPath());
+    const QStringList names = pending.entryList({"*.rec", "*.claimed"}, QDir::Files, QDir::Name);
+    if (names.isEmpty())
+        return true;
+
+    const QList<int> segments = segmentNumbers();
+    int active = segments.isEmpty() ? latestSnapshot() + 1 : segments.last();
+
+    QFile file(segmentPath(active));
+    if (file.exists() && file.size() >= kSegmentLimit) {
+        ++active;
+        file.setFileName(segmentPath(active));
+        if (segments.size() >= kCompactThreshold)
+            compactInBackground();
+    }
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+
+    QByteArray batch;
+    QByteArray intentLines;
+    QList<QPair<QString, qint64>> receipts;
+    const qint64 start = file.size();
+    qint64 offset = start;
+    for (const QString &name : names) {
+        // Запись забирается переименованием: либо её успел отозвать автор,
+        // не дождавшийся блокировки, либо она точно попадёт в этот пакет
+        const QString id = name.left(name.lastIndexOf('.'));
+        const QString base = pending.filePath(id);
+        const QString claimed = base + ".claimed";
+        if (name.endsWith(".rec") && !QFile::rename(base + ".rec", claimed))
+            continue;
+        QFile in(claimed);
+        if (!in.open(QIODevice::ReadOnly))
+            continue;
+        const QByteArray lines = in.readAll();
+        in.close();
+        if (lines.isEmpty() || !lines.endsWith('\n')) {
+            // Неполная запись в журнал не попадёт; автор получит false
+            in.remove();
+            continue;
+        }
+        receipts.append({base, offset});
+        intentLines += QByteArray::number(offset) + ' ' + id.toUtf8() + '\n';
+        batch += lines;
+        offset += lines.size();
+    }
+    if (batch.isEmpty())
+        return true;
+
+    QSaveFile intent(intentPath());
+    if (!intent.open(QIODevice::WriteOnly))
+        return false;
+    intent.write(QByteArray::number(active) + ' ' + QByteArray::number(start) + ' '
+                 + QByteArray::number(offset) + '\n' + intentLines);
+    if (!intent.commit())
+        return false;
+
+    if (file.write(batch) != batch.size() || !JournalLine::syncFile(file)) {
+        // Пакет не записан: хвост отрезается, забранные записи остаются в очереди
+        if (file.resize(start))
+            QFile::remove(intentPath());
+        return false;
+    }
+    file.close();
+    ++commits;
+
+    finishBatch(active, receipts);
+
+    // Квитанции авторов, не дождавшихся фиксации, со временем удаляются;
+    // квитанция миграции scores.json нужна, пока миграция не завершена
+    const QFileInfoList receiptsLeft = pending.entryInfoList({"*.done"}, QDir::Files);
+    const QDateTime staleBefore = QDateTime::currentDateTime().addSecs(-kStaleReceiptSecs);
+    for (const QFileInfo &info : receiptsLeft) {
+        if (info.lastModified() < staleBefore && info.fileName() != kLegacyReceipt)
+            QFile::remove(info.filePath());
+    }
+    return true;
+}
+
+qint64 ScoreJournal::readSegment(int number, qint64 from, QList<QJsonObject> *records,
+                                 QList<qint64> *offsets) const
+{
+    QFile file(segmentPath(number));
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(from))
+        return from;
+
+    // Недописанная последняя строка будет прочитана при следующем обращении
+    qint64 end = from;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (!line.endsWith('\n'))
+            break;
+        QJsonObject record;
+        if (JournalLine::decode(line, &record)) {
+            records->append(record);
+            if (offsets)
+                offsets->append(end);
+        }
+        end += line.size();
+    }
+    return end;
+}
+
+int ScoreJournal::readSnapshot(QList<QJsonObject> *records) const
+{
+    const int snapshot = latestSnapshot();
+    if (snapshot >= 0)
+        readFile(snapshotPath(snapshot), records);
+    return snapshot;
+}
+
+QList<QJsonObject> ScoreJournal::readAll() const
+{
+    QList<QJsonObject> records;
+    readSnapshot(&records);
+
+    for (int number : segmentNumbers())
+        readFile(segmentPath(number), &records);
+
+    return records;
+}
+
+bool ScoreJournal::compact()
+{
+    // Сворачивание удаляет файлы, поэтому одновременно его выполняет только
+    // один поток одного процесса; писателей оно не блокирует
+    QMutexLocker locker(&compactionMutex());
+    QLockFile lock(dirPath + "/compact.lock");
+    if (!lock.tryLock(0))
+        return false;
+
+    // Активный (последний) сегмент не трогаем — в него продолжают писать
+    const QList<int> segments = segmentNumbers();
+    if (segments.size() < 2)
+        return true;
+
+    const int previous = latestSnapshot();
+    const int foldUpTo = segments[segments.size() - 2];
+
+    QSaveFile out(snapshotPath(foldUpTo));
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+
+    QStringList sources;
+    if (previous >= 0)
+        sources << snapshotPath(previous);
+    for (int number : segments) {
+        if (number <= foldUpTo)
+            sources << segmentPath(number);
+    }
+
+    for (const QString &source : sources) {
+        QFile in(source);
+        if (!in.open(QIODevice::ReadOnly))
+            continue;
+        while (!in.atEnd()) {
+            QByteArray line = in.readLine();
+            QJsonObject record;
+            if (!JournalLine::decode(line, &record))
+                continue;
+            if (!line.endsWith('\n'))
+                line.append('\n');
+            out.write(line);
+        }
+    }
+
+    if (!out.commit())
+        return false;
+
+    // Снимок заменён атомарно, теперь старые файлы можно удалить
+    for (int number : numbersOf(dirPath, "snapshot-*.log")) {
+        if (number < foldUpTo)
+            QFile::remove(snapshotPath(number));
+    }
+    for (int number : numbersOf(dirPath, "segment-*.log")) {
+        if (number <= foldUpTo)
+            QFile::remove(segmentPath(number));
+    }
+    return true;
+}
+
+void ScoreJournal::compactInBackground()
+{
+    const QString path = dirPath;
+    QThreadPool::globalInstance()->start([path]() {
+        ScoreJournal(path).compact();
+    });
+}
+
+bool ScoreJournal::migrateLegacyFile()
+{
+    const QString migrating = legacyFilePath() + ".migrating";
+    if (!QFile::exists(legacyFilePath()) && !QFile::exists(migrating))
+        return false;
+
+    QLockFile lock(lockPath());
+    if (!lock.tryLock(kLockTimeoutMs))
+        return false;
+
+    // Файл переносится под блокировкой через промежуточное имя: если процесс
+    // упадёт посреди миграции, следующий запуск увидит .migrating и по
+    // снимку или квитанции поймёт, что записи уже в журнале
+    if (QFile::exists(migrating) && !migrateFile(migrating))
+        return false;
+    if (!QFile::exists(legacyFilePath()))
+        return true;
+    // Квитанция могла остаться от прошлой миграции, упавшей после переименования
+    QFile::remove(pendingPath() + "/" + kLegacyReceipt);
+    if (!QFile::rename(legacyFilePath(), migrating))
+        return false;
+    return migrateFile(migrating);
+}
+
+bool ScoreJournal::migrateFile(const QString &filePath)
+{
+    QFile legacy(filePath);
+    if (!legacy.open(QIODevice::ReadOnly))
+        return false;
+    const QJsonArray scoresArray = QJsonDocument::fromJson(legacy.readAll()).array();
+    legacy.close();
+
+    QByteArray lines;
+    for (const QJsonValue &val : scoresArray)
+        lines += JournalLine::encode(val.toObject());
+
+    // Пакет, прерванный сбоем, доводится до конца раньше проверки квитанции
+    if (!recoverBatch())
+        return false;
+
+    const QString receiptPath = pendingPath() + "/" + kLegacyReceipt;
+    bool committed = lines.isEmpty() || QFile::exists(receiptPath);
+    if (!committed && latestSnapshot() >= 0) {
+        // Сворачивание сохраняет порядок, поэтому перенесённая в снимок
+        // история остаётся его началом и в более поздних снимках
+        QFile snapshot(snapshotPath(latestSnapshot()));
+        committed = snapshot.open(QIODevice::ReadOnly) && snapshot.read(lines.size()) == lines;
+    }
+
+    if (!committed && latestSnapshot() < 0 && segmentNumbers().isEmpty()) {
+        QSaveFile out(snapshotPath(0));
+        if (!out.open(QIODevice::WriteOnly))
+            return false;
+        out.write(lines);
+        if (!out.commit())
+            return false;
+    } else if (!committed) {
+        // scores.json снова появился (его записала старая версия программы) —
+        // его записи сливаются с журналом одним пакетом
+        const QString base = pendingPath() + "/legacy";
+        QFile batch(base + ".tmp");
+        if (!batch.open(QIODevice::WriteOnly) || batch.write(lines) != lines.size())
+            return false;
+        batch.close();
+        if (!QFile::rename(base + ".tmp", base + ".rec") || !commitPending())
+            return false;
+    }
+
+    // Старый файл сохраняем рядом, чтобы миграция не повторялась
+    QString migrated = legacyFilePath() + ".migrated";
+    if (QFile::exists(migrated))
+        migrated += "." + QString::number(QDateTime::currentMSecsSinceEpoch());
+    if (!QFile::rename(filePath, migrated))
+        return false;
+    QFile::remove(receiptPath);
+    return true;
+}
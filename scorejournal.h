@@ -0,0 +1,68 @@
+#ifndef SCOREJOURNAL_H
+#define SCOREJOURNAL_H
+
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QJsonObject>
+
+// Журнал результатов: каталог с сегментами "segment-XXXXXXXX.log" и снимком
+// "snapshot-XXXXXXXX.log" (номер — последний свёрнутый в него сегмент).
+// Каждая строка — "<crc32>\t<json>", запись только дописывается в конец
+// активного сегмента, поэтому её стоимость не зависит от размера истории.
+// Несколько процессов могут писать одновременно: запись фиксируется под
+// межпроцессной блокировкой пакетами (group commit) с одним fsync на пакет.
+// Состав пакета сохраняется до его записи, поэтому фиксация, прерванная
+// сбоем, завершается следующим писателем без потерь и повторов.
+class ScoreJournal
+{
+public:
+    explicit ScoreJournal(const QString &dirPath = defaultPath());
+
+    static QString defaultPath();
+    QString legacyFilePath() const;
+
+    struct Position
+    {
+        int segment = -1;
+        qint64 offset = -1;
+    };
+
+    // false — запись не попала и не попадёт в журнал, вызов можно повторить
+    bool append(const QJsonObject &record, Position *position = nullptr);
+    bool appendBatch(const QByteArray &lines, Position *position = nullptr);
+    void setLockTimeout(int ms) { lockTimeoutMs = ms; }
+    // Сколько пакетов (fsync сегмента) записал этот объект
+    int commitCount() const { return commits; }
+    QList<QJsonObject> readAll() const;
+    int readSnapshot(QList<QJsonObject> *records) const;
+    qint64 readSegment(int number, qint64 from, QList<QJsonObject> *records,
+                       QList<qint64> *offsets = nullptr) const;
+
+    bool compact();
+    void compactInBackground();
+
+    QString path() const { return dirPath; }
+    QList<int> segmentNumbers() const;
+    int latestSnapshot() const;
+    QString segmentPath(int number) const;
+    QString snapshotPath(int number) const;
+
+private:
+    bool migrateLegacyFile();
+    bool migrateFile(const QString &filePath);
+    bool commitPending();
+    bool recoverBatch();
+    void finishBatch(int segment, const QList<QPair<QString, qint64>> &receipts);
+    QString pendingPath() const;
+    QString lockPath() const;
+    QString intentPath() const;
+
+    static void readFile(const QString &filePath, QList<QJsonObject> *records);
+
+    QString dirPath;
+    int lockTimeoutMs;
+    int commits = 0;
+};
+
+#endif // SCOREJOURNAL_H
@@ -0,0 +1,210 @@
+#include "scorestore.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <QJsonArray>
+
+QJsonObject ScoreRecord::toJson() const
+{
+    QJsonObject obj;
+    obj["name"] = name;
+    obj["score"] = score;
+    obj["quiz"] = quiz;
+    if (!plan.isEmpty())
+        obj["plan"] = plan;
+    if (!times.isEmpty()) {
+        // Время ответа на каждый вопрос плана по порядку, мс
+        QJsonArray timesArray;
+        for (int ms : times)
+            timesArray.append(ms);
+        obj["times"] = timesArray;
+    }
+    if (!answers.isEmpty()) {
+        // [вопрос, выбранные, правильные] — по одному на показанный вопрос
+        QJsonArray answersArray;
+        for (const Answer &answer : answers)
+            answersArray.append(QJsonArray{answer.question, int(answer.mask), int(answer.key)});
+        obj["answers"] = answersArray;
+    }
+    return obj;
+}
+
+ScoreRecord ScoreRecord::fromJson(const QJsonObject &obj)
+{
+    ScoreRecord record;
+    record.name = obj["name"].toString();
+    record.score = obj["score"].toInt();
+    record.quiz = obj["quiz"].toString();
+    record.plan = obj["plan"].toObject();
+    for (const QJsonValue &ms : obj["times"].toArray())
+        record.times.append(ms.toInt());
+    for (const QJsonValue &value : obj["answers"].toArray()) {
+        const QJsonArray triple = value.toArray();
+        Answer answer;
+        answer.question = triple.at(0).toInt(-1);
+        answer.mask = quint8(triple.at(1).toInt());
+        answer.key = quint8(triple.at(2).toInt());
+        if (answer.question >= 0)
+            record.answers.append(answer);
+    }
+    return record;
+}
+
+ScoreStore *ScoreStore::instance()
+{
+    static ScoreStore *store = new ScoreStore(ScoreJournal::defaultPath(), QCoreApplication::instance());
+    return store;
+}
+
+ScoreStore::ScoreStore(const QString &journalPath, QObject *parent)
+    : QObject(parent), journal(journalPath)
+{
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, &ScoreStore::scheduleRefresh);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &ScoreStore::scheduleRefresh);
+    watcher.addPath(journal.path());
+
+    reload();
+}
+
+void ScoreStore::reload()
+{
+    records.clear();
+    overall = LeaderboardIndex();
+    byQuiz.clear();
+    statsByQuiz.clear();
+    segmentOffsets.clear();
+
+    QList<QJsonObject> stored;
+    loadedSnapshot = journal.readSnapshot(&stored);
+    for (int number : journal.segmentNumbers())
+        segmentOffsets[number] = journal.readSegment(number, 0, &stored);
+
+    records.reserve(stored.size());
+    for (const QJsonObject &obj : stored)
+        insert(obj);
+
+    watchSegments();
+}
+
+void ScoreStore::refresh()
+{
+    refreshScheduled = false;
+
+    // После сворачивания сегментов в снимок проще перечитать всё заново
+    if (journal.latestSnapshot() != loadedSnapshot) {
+        reload();
+        emit reloaded();
+        return;
+    }
+
+    const int before = records.size();
+    for (int number : journal.segmentNumbers()) {
+        QList<QJsonObject> fresh;
+        qint64 &offset = segmentOffsets[number];
+        offset = journal.readSegment(number, offset, &fresh);
+        for (const QJsonObject &obj : fresh)
+            insert(obj);
+    }
+
+    watchSegments();
+    if (records.size() != before)
+        emit recordsAdded();
+}
+
+void ScoreStore::scheduleRefresh()
+{
+    if (refreshScheduled)
+        return;
+    refreshScheduled = true;
+    QTimer::singleShot(50, this, &ScoreStore::refresh);
+}
+
+void ScoreStore::watchSegments()
+{
+    for (int number : journal.segmentNumbers()) {
+        const QString path = journal.segmentPath(number);
+        if (!watcher.files().contains(path))
+            watcher.addPath(path);
+    }
+}
+
+int ScoreStore::insert(const QJsonObject &obj)
+{
+    records.append(ScoreRecord::fromJson(obj));
+    const int id = records.size() - 1;
+    const ScoreRecord &rec = records[id];
+
+    overall.insert(id, rec.score);
+    auto it = byQuiz.find(rec.quiz);
+    if (it == byQuiz.end()) {
+        it = byQuiz.emplace(rec.quiz, LeaderboardIndex()).first;
+        emit quizAdded(rec.quiz);
+    }
+    it->second.insert(id, rec.score);
+    auto stats = statsByQuiz.find(rec.quiz);
+    if (stats != statsByQuiz.end() && !rec.answers.isEmpty())
+        stats->second.add(rec);
+    return id;
+}
+
+int ScoreStore::add(const ScoreRecord &record)
+{
+    ScoreJournal::Position position;
+    if (!journal.append(record.toJson(), &position))
+        return -1;
+
+    // Дочитываем журнал сразу: вместе со своей записью подхватятся и чужие
+    const int before = records.size();
+    QList<QJsonObject> fresh;
+    QList<qint64> offsets;
+    int ownId = -1;
+    for (int number : journal.segmentNumbers()) {
+        fresh.clear();
+        offsets.clear();
+        qint64 &offset = segmentOffsets[number];
+        offset = journal.readSegment(number, offset, &fresh, &offsets);
+        for (int i = 0; i < fresh.size(); ++i) {
+            const int id = insert(fresh[i]);
+            if (number == position.segment && offsets[i] == position.offset)
+                ownId = id;
+        }
+    }
+
+    watchSegments();
+    if (records.size() != before)
+        emit recordsAdded();
+    return ownId;
+}
+
+QStringList ScoreStore::quizzes() const
+{
+    QStringList names;
+    for (const auto &entry : byQuiz)
+        names.append(entry.first);
+    return names;
+}
+
+const LeaderboardIndex *ScoreStore::leaderboard(const QString &quiz) const
+{
+    if (quiz.isEmpty())
+        return &overall;
+
+    auto it = byQuiz.find(quiz);
+    return it == byQuiz.end() ? nullptr : &it->second;
+}
+
+const ItemStats *ScoreStore::itemStats(const QString &quiz, int questionCount)
+{
+    auto it = statsByQuiz.find(quiz);
+    if (it != statsByQuiz.end() && it->second.questionCount() == questionCount)
+        return it->second.records() > 0 ? &it->second : nullptr;
+
+    // Записи перебираются в порядке журнала: от него зависит, какой ключ вопроса последний
+    ItemStats stats(questionCount);
+    for (const ScoreRecord &rec : records) {
+        if (rec.quiz == quiz && !rec.answers.isEmpty())
+            stats.add(rec);
+    }
+    it = statsByQuiz.insert_or_assign(quiz, std::move(stats)).first;
+    return it->second.records() > 0 ? &it->second : nullptr;
+}
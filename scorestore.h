@@ -0,0 +1,92 @@
+#ifndef SCORESTORE_H
+#define SCORESTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QJsonObject>
+#include <QFileSystemWatcher>
+#include <map>
+
+#include "leaderboardindex.h"
+#include "scorejournal.h"
+#include "itemstats.h"
+
+struct ScoreRecord
+{
+    // Ответ на один вопрос: маски выбранных и правильных вариантов в исходном
+    // порядке вопроса. Ключ сохраняется на момент ответа, поэтому поздние
+    // правки викторины не меняют смысл старых ответов.
+    struct Answer
+    {
+        int question = 0;
+        quint8 mask = 0;
+        quint8 key = 0;
+
+        bool correct() const { return mask == key; }
+    };
+
+    QString name;
+    QString quiz;
+    int score = 0;
+    QJsonObject plan;
+    QVector<int> times;
+    QVector<Answer> answers;
+
+    QJsonObject toJson() const;
+    static ScoreRecord fromJson(const QJsonObject &obj);
+};
+
+// Общий для всех окон кэш результатов: журнал читается один раз, затем
+// дочитываются только новые строки сегментов, когда они меняются на диске.
+// Для каждой викторины ведётся рейтинговый индекс (пустое имя — общий рейтинг),
+// для запрошенных викторин — статистика вопросов; оба обновляются по одной
+// записи, без пересчёта.
+class ScoreStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ScoreStore *instance();
+
+    int add(const ScoreRecord &record);
+
+    int recordCount() const { return records.size(); }
+    const ScoreRecord &record(int id) const { return records[id]; }
+
+    QStringList quizzes() const;
+    const LeaderboardIndex *leaderboard(const QString &quiz = QString()) const;
+    // Строится по истории при первом запросе и после смены числа вопросов
+    // викторины, дальше обновляется по одной записи
+    const ItemStats *itemStats(const QString &quiz, int questionCount);
+
+signals:
+    void recordsAdded();
+    void quizAdded(const QString &quiz);
+    void reloaded();
+
+private:
+    explicit ScoreStore(const QString &journalPath, QObject *parent = nullptr);
+
+    void reload();
+    void refresh();
+    void scheduleRefresh();
+    int insert(const QJsonObject &obj);
+    void watchSegments();
+
+    ScoreJournal journal;
+    QFileSystemWatcher watcher;
+    bool refreshScheduled = false;
+
+    int loadedSnapshot = -1;
+    QHash<int, qint64> segmentOffsets;
+
+    QVector<ScoreRecord> records;
+    LeaderboardIndex overall;
+    std::map<QString, LeaderboardIndex> byQuiz;
+    std::map<QString, ItemStats> statsByQuiz;
+};
+
+#endif // SCORESTORE_H
@@ -0,0 +1,113 @@
+#include "scoretablemodel.h"
+#include "scorestore.h"
+
+#include <QFont>
+#include <algorithm>
+
+namespace {
+const int kPageSize = 100;
+}
+
+ScoreTableModel::ScoreTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ScoreTableModel::setQuiz(const QString &quiz)
+{
+    // Хранилище загружается при первом обращении, а не при создании окна
+    ScoreStore *store = ScoreStore::instance();
+    connect(store, &ScoreStore::recordsAdded, this, &ScoreTableModel::storeChanged, Qt::UniqueConnection);
+    connect(store, &ScoreStore::reloaded, this, &ScoreTableModel::storeChanged, Qt::UniqueConnection);
+
+    beginResetModel();
+    this->quiz = quiz;
+    leaderboard = store->leaderboard(quiz);
+    loadedRows = std::min(kPageSize, availableRows());
+    endResetModel();
+}
+
+void ScoreTableModel::storeChanged()
+{
+    // Новые записи могут встать в середину рейтинга, поэтому сбрасываем модель,
+    // сохраняя количество уже подгруженных строк
+    beginResetModel();
+    leaderboard = ScoreStore::instance()->leaderboard(quiz);
+    loadedRows = std::min(std::max(loadedRows, kPageSize), availableRows());
+    endResetModel();
+}
+
+void ScoreTableModel::setHighlightedRecord(int recordId)
+{
+    highlightedRecord = recordId;
+    if (loadedRows > 0)
+        emit dataChanged(index(0, 0), index(loadedRows - 1, columnCount() - 1), {Qt::FontRole});
+}
+
+int ScoreTableModel::availableRows() const
+{
+    return leaderboard ? leaderboard->count() : 0;
+}
+
+int ScoreTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : loadedRows;
+}
+
+int ScoreTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 2;
+}
+
+QVariant ScoreTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !leaderboard)
+        return QVariant();
+
+    const int recordId = leaderboard->recordAt(index.row());
+    if (recordId < 0)
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        const ScoreRecord &rec = ScoreStore::instance()->record(recordId);
+        return index.column() == 0 ? QVariant(rec.name) : QVariant(rec.score);
+    }
+
+    if (role == Qt::FontRole && recordId == highlightedRecord) {
+        QFont font;
+        font.setBold(true);
+        return font;
+    }
+
+    return QVariant();
+}
+
+QVariant ScoreTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Vertical)
+        return section + 1;
+
+    return section == 0 ? QString("ФИО") : QString("Баллы");
+}
+
+bool ScoreTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && loadedRows < availableRows();
+}
+
+void ScoreTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
+        return;
+
+    const int toFetch = std::min(kPageSize, availableRows() - loadedRows);
+    if (toFetch <= 0)
+        return;
+
+    beginInsertRows(QModelIndex(), loadedRows, loadedRows + toFetch - 1);
+    loadedRows += toFetch;
+    endInsertRows();
+}
@@ -0,0 +1,39 @@
+#ifndef SCORETABLEMODEL_H
+#define SCORETABLEMODEL_H
+
+#include <QAbstractTableModel>
+
+class LeaderboardIndex;
+
+// Таблица рекордов поверх рейтингового индекса общего ScoreStore: строки
+// подгружаются страницами через fetchMore, данные строки берутся из индекса
+// по запросу. При изменении хранилища модель обновляется сама.
+class ScoreTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ScoreTableModel(QObject *parent = nullptr);
+
+    void setQuiz(const QString &quiz);
+    void setHighlightedRecord(int recordId);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    int availableRows() const;
+    void storeChanged();
+
+    QString quiz;
+    const LeaderboardIndex *leaderboard = nullptr;
+    int loadedRows = 0;
+    int highlightedRecord = -1;
+};
+
+#endif // SCORETABLEMODEL_H
@@ -0,0 +1,39 @@
+#include "scoring.h"
+#include "quizsource.h"
+
+int Scoring::secondsFor(int difficulty)
+{
+    switch (difficulty) {
+    case 1: return 20;
+    case 2: return 35;
+    case 3: return 90;
+    default: return 35;
+    }
+}
+
+int Scoring::timeBudget(const QuizSource &quiz, int first, int last)
+{
+    int totalSeconds = 0;
+    for (int i = first; i < last; ++i)
+        totalSeconds += secondsFor(quiz.difficulty(i));
+    return totalSeconds;
+}
+
+int Scoring::points(quint8 correctMask, int difficulty, quint8 answerMask)
+{
+    // Баллы начисляются только за полностью совпавший набор вариантов
+    return answerMask == correctMask ? difficulty : 0;
+}
+
+int Scoring::points(const Question &question, quint8 answerMask)
+{
+    return points(question.correctMask, question.difficulty, answerMask);
+}
+
+int Scoring::maxScore(const QuizSource &quiz)
+{
+    int total = 0;
+    for (int i = 0; i < quiz.count(); ++i)
+        total += quiz.difficulty(i);
+    return total;
+}
@@ -0,0 +1,22 @@
+#ifndef SCORING_H
+#define SCORING_H
+
+#include <QtGlobal>
+
+#include "question.h"
+
+class QuizSource;
+
+// Правила подсчёта баллов и времени, общие для окна прохождения и QuizCli.
+// Ответ задаётся маской выбранных вариантов в исходном порядке вопроса.
+namespace Scoring
+{
+int secondsFor(int difficulty);
+int timeBudget(const QuizSource &quiz, int first, int last);
+
+int points(quint8 correctMask, int difficulty, quint8 answerMask);
+int points(const Question &question, quint8 answerMask);
+int maxScore(const QuizSource &quiz);
+}
+
+#endif // SCORING_H
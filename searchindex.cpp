@@ -0,0 +1,119 @@
+#include "searchindex.h"
+
+#include <QtAlgorithms>
+#include <algorithm>
+
+QStringList SearchIndex::tokenize(const QString &text)
+{
+    QStringList tokens;
+    QString current;
+    for (const QChar ch : text) {
+        if (ch.isLetterOrNumber()) {
+            current += ch == QChar(0x0451) || ch == QChar(0x0401) ? QChar(0x0435) : ch.toCaseFolded();
+        } else if (!current.isEmpty()) {
+            tokens << current;
+            current.clear();
+        }
+    }
+    if (!current.isEmpty())
+        tokens << current;
+    return tokens;
+}
+
+QStringList SearchIndex::termsOf(const Question &question)
+{
+    QStringList terms = tokenize(question.text);
+    for (const QString &option : question.options)
+        terms += tokenize(option);
+    terms.sort();
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+void SearchIndex::clear()
+{
+    postings.clear();
+    documents = 0;
+}
+
+void SearchIndex::insertPosting(const QString &term, int id)
+{
+    QVector<int> &list = postings[term];
+    // При загрузке номера растут, так что обычно это просто добавление в конец
+    if (list.isEmpty() || list.last() < id) {
+        list.append(id);
+        return;
+    }
+    auto it = std::lower_bound(list.begin(), list.end(), id);
+    if (it == list.end() || *it != id)
+        list.insert(it, id);
+}
+
+void SearchIndex::removePosting(const QString &term, int id)
+{
+    auto entry = postings.find(term);
+    if (entry == postings.end())
+        return;
+    QVector<int> &list = entry->second;
+    auto it = std::lower_bound(list.begin(), list.end(), id);
+    if (it != list.end() && *it == id)
+        list.erase(it);
+    if (list.isEmpty())
+        postings.erase(entry);
+}
+
+void SearchIndex::add(int id, const Question &question)
+{
+    for (const QString &term : termsOf(question))
+        insertPosting(term, id);
+    documents = qMax(documents, id + 1);
+}
+
+void SearchIndex::update(int id, const Question &before, const Question &after)
+{
+    // Прямой индекс не хранится: старые слова берутся из прежнего текста вопроса
+    for (const QString &term : termsOf(before))
+        removePosting(term, id);
+    add(id, after);
+}
+
+QVector<int> SearchIndex::search(const QString &query) const
+{
+    const QStringList words = tokenize(query);
+    if (words.isEmpty())
+        return QVector<int>();
+
+    // Для каждого слова запроса объединяем списки всех слов с этим префиксом
+    // в битовую маску; маски слов пересекаются
+    const int wordCount = (documents + 63) / 64;
+    QVector<quint64> matched;
+    for (int w = 0; w < words.size(); ++w) {
+        const QString &prefix = words[w];
+        QVector<quint64> bits(wordCount, 0);
+        const bool exact = prefix.size() < kMinPrefix;
+        for (auto it = postings.lower_bound(prefix); it != postings.end() && it->first.startsWith(prefix); ++it) {
+            if (exact && it->first != prefix)
+                break;
+            for (int id : it->second)
+                bits[id >> 6] |= quint64(1) << (id & 63);
+        }
+
+        if (w == 0) {
+            matched = bits;
+        } else {
+            for (int i = 0; i < wordCount; ++i)
+                matched[i] &= bits[i];
+        }
+    }
+
+    QVector<int> ids;
+    for (int i = 0; i < wordCount; ++i) {
+        quint64 word = matched[i];
+        while (word) {
+            const int bit = qCountTrailingZeroBits(word);
+            ids.append(i * 64 + bit);
+            word &= word - 1;
+        }
+    }
+    return ids;
+}
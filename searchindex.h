@@ -0,0 +1,43 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <map>
+
+#include "question.h"
+
+// Инвертированный индекс по тексту вопросов и вариантов ответа. Слова
+// выделяются по свойствам Unicode (буквы и цифры), приводятся к нижнему
+// регистру, «ё» считается «е». Словарь отсортирован, поэтому все слова с
+// заданным префиксом лежат подряд. Запрос из нескольких слов находит
+// вопросы, где каждое слово запроса является префиксом какого-то слова.
+// Слова короче kMinPrefix ищутся только целиком: префикс из одной-двух букв
+// охватывает почти весь словарь, и каждое нажатие клавиши объединяло бы
+// почти все списки.
+class SearchIndex
+{
+public:
+    static constexpr int kMinPrefix = 3;
+
+    static QStringList tokenize(const QString &text);
+
+    void clear();
+    void add(int id, const Question &question);
+    void update(int id, const Question &before, const Question &after);
+
+    QVector<int> search(const QString &query) const;
+    int documentCount() const { return documents; }
+
+private:
+    static QStringList termsOf(const Question &question);
+    void insertPosting(const QString &term, int id);
+    void removePosting(const QString &term, int id);
+
+    // Списки номеров вопросов по возрастанию
+    std::map<QString, QVector<int>> postings;
+    int documents = 0;
+};
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,102 @@
+#include "sessionclient.h"
+
+using namespace SessionProtocol;
+
+SessionClient::SessionClient(QObject *parent)
+    : QObject(parent)
+{
+    connect(&socket, &QTcpSocket::connected, this, [this]() {
+        socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        socket.write(Writer(Hello).string(name).frame());
+    });
+    connect(&socket, &QTcpSocket::readyRead, this, &SessionClient::onReadyRead);
+    connect(&socket, &QTcpSocket::disconnected, this, &SessionClient::disconnected);
+    connect(&socket, &QAbstractSocket::errorOccurred, this, [this](QAbstractSocket::SocketError error) {
+        // Закрытие соединения сервером после итогов — не ошибка
+        if (error != QAbstractSocket::RemoteHostClosedError)
+            emit failed(socket.errorString());
+    });
+}
+
+void SessionClient::connectToServer(const QString &host, quint16 port, const QString &playerName)
+{
+    name = playerName;
+    socket.connectToHost(host, port);
+}
+
+void SessionClient::sendAnswer(int position, quint8 shownMask)
+{
+    socket.write(Writer(Answer).i32(position).u8(shownMask).frame());
+}
+
+void SessionClient::disconnectFromServer()
+{
+    socket.disconnectFromHost();
+}
+
+void SessionClient::onReadyRead()
+{
+    input.append(socket.readAll());
+    MessageType type;
+    QByteArray payload;
+    while (input.next(&type, &payload))
+        handle(type, payload);
+}
+
+void SessionClient::handle(MessageType type, const QByteArray &payload)
+{
+    Reader reader(payload);
+    switch (type) {
+    case Welcome: {
+        quiz = reader.string();
+        const int count = reader.i32();
+        if (reader.ok())
+            emit welcomed(quiz, count);
+        break;
+    }
+    case QuestionShown: {
+        const int position = reader.i32();
+        const int total = reader.i32();
+        const QString text = reader.string();
+        QStringList options;
+        for (int i = 0; i < 4; ++i)
+            options << reader.string();
+        const int difficulty = reader.u8();
+        const int remaining = reader.i32();
+        if (reader.ok())
+            emit questionShown(position, total, text, options, difficulty, remaining);
+        break;
+    }
+    case AnswerResult: {
+        const int position = reader.i32();
+        const int points = reader.i32();
+        const int score = reader.i32();
+        if (reader.ok())
+            emit answerResult(position, points, score);
+        break;
+    }
+    case Standings: {
+        QVector<Standing> rows(reader.u16());
+        for (Standing &row : rows) {
+            row.name = reader.string();
+            row.score = reader.i32();
+        }
+        if (reader.ok())
+            emit standings(rows);
+        break;
+    }
+    case Finished: {
+        const int score = reader.i32();
+        const int rank = reader.i32();
+        const int participants = reader.i32();
+        if (reader.ok())
+            emit finished(score, rank, participants);
+        break;
+    }
+    case Error:
+        emit failed(reader.string());
+        break;
+    default:
+        break;
+    }
+}
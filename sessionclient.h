@@ -0,0 +1,47 @@
+#ifndef SESSIONCLIENT_H
+#define SESSIONCLIENT_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QStringList>
+#include <QVector>
+
+#include "sessionprotocol.h"
+
+// Клиент сессии класса: подключение к SessionServer, разбор сообщений в
+// сигналы и отправка ответов. Не зависит от окон, поэтому им же пользуется
+// нагрузочный тест.
+class SessionClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionClient(QObject *parent = nullptr);
+
+    void connectToServer(const QString &host, quint16 port, const QString &name);
+    void sendAnswer(int position, quint8 shownMask);
+    void disconnectFromServer();
+
+    QString quizName() const { return quiz; }
+
+signals:
+    void welcomed(const QString &quizName, int questionCount);
+    void questionShown(int position, int total, const QString &text, const QStringList &options,
+                       int difficulty, int remainingMs);
+    void answerResult(int position, int points, int score);
+    void standings(const QVector<SessionProtocol::Standing> &rows);
+    void finished(int score, int rank, int participants);
+    void failed(const QString &message);
+    void disconnected();
+
+private:
+    void onReadyRead();
+    void handle(SessionProtocol::MessageType type, const QByteArray &payload);
+
+    QTcpSocket socket;
+    SessionProtocol::FrameBuffer input;
+    QString name;
+    QString quiz;
+};
+
+#endif // SESSIONCLIENT_H
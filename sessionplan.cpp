@@ -0,0 +1,124 @@
+#include "sessionplan.h"
+#include "compiledquiz.h"
+
+#include <QHash>
+
+void DifficultyIndex::append(const CompiledQuiz &quiz, int first, int last)
+{
+    for (int i = first; i < last; ++i) {
+        const int difficulty = quiz.difficulty(i);
+        levels[difficulty >= 1 && difficulty <= kLevels ? difficulty - 1 : 1].append(i);
+    }
+}
+
+SessionPlan::Request SessionPlan::Request::sequential(quint64 seed)
+{
+    Request request;
+    request.seed = seed;
+    return request;
+}
+
+QJsonObject SessionPlan::Request::toJson() const
+{
+    QJsonObject obj;
+    // 64-битное зерно не помещается в double JSON без потерь
+    obj["seed"] = QString::number(seed);
+    if (sampled) {
+        obj["easy"] = counts[0];
+        obj["medium"] = counts[1];
+        obj["hard"] = counts[2];
+    }
+    if (perQuestionLimit)
+        obj["perQuestion"] = true;
+    if (adaptive()) {
+        obj["adaptive"] = adaptiveLength;
+        obj["targetError"] = targetError;
+    }
+    return obj;
+}
+
+SessionPlan::Request SessionPlan::Request::fromJson(const QJsonObject &obj)
+{
+    Request request;
+    request.seed = obj["seed"].toString().toULongLong();
+    request.sampled = obj.contains("easy");
+    request.counts[0] = obj["easy"].toInt();
+    request.counts[1] = obj["medium"].toInt();
+    request.counts[2] = obj["hard"].toInt();
+    request.perQuestionLimit = obj["perQuestion"].toBool();
+    request.adaptiveLength = obj["adaptive"].toInt();
+    request.targetError = obj["targetError"].toDouble();
+    return request;
+}
+
+quint64 SessionPlan::randomSeed()
+{
+    std::random_device device;
+    return (quint64(device()) << 32) | device();
+}
+
+SessionPlan::SessionPlan(const Request &request)
+    : spec(request), rng(request.seed)
+{
+}
+
+quint64 SessionPlan::bounded(quint64 bound)
+{
+    // Отбрасываются значения из неполного последнего диапазона, чтобы остаток был равномерным
+    const quint64 threshold = (0 - bound) % bound;
+    quint64 value;
+    do {
+        value = rng();
+    } while (value < threshold);
+    return value % bound;
+}
+
+SessionPlan::Item SessionPlan::makeItem(int question)
+{
+    Item item;
+    item.question = question;
+    for (int i = 3; i > 0; --i)
+        qSwap(item.order[i], item.order[bounded(i + 1)]);
+    return item;
+}
+
+void SessionPlan::extendSequential(int questionCount)
+{
+    items.reserve(questionCount);
+    for (int i = items.size(); i < questionCount; ++i)
+        items.append(makeItem(i));
+}
+
+void SessionPlan::appendQuestion(int question)
+{
+    items.append(makeItem(question));
+}
+
+void SessionPlan::sample(const DifficultyIndex &index)
+{
+    items.clear();
+    int total = 0;
+    for (int level = 0; level < DifficultyIndex::kLevels; ++level)
+        total += qMin(spec.counts[level], index.level(level + 1).size());
+    items.reserve(total);
+
+    for (int level = 0; level < DifficultyIndex::kLevels; ++level) {
+        const QVector<int> &pool = index.level(level + 1);
+        const int n = pool.size();
+        const int k = qMin(spec.counts[level], n);
+
+        // Разреженный Фишер–Йейтс: хранятся только переставленные позиции
+        QHash<int, int> moved;
+        moved.reserve(2 * k);
+        for (int i = 0; i < k; ++i) {
+            const int j = i + int(bounded(quint64(n - i)));
+            const int picked = moved.value(j, j);
+            moved.insert(j, moved.value(i, i));
+            items.append(makeItem(pool[picked]));
+        }
+    }
+
+    // Уровни перемешиваются между собой, чтобы сложные не шли подряд в конце
+    for (int i = items.size() - 1; i > 0; --i)
+        qSwap(items[i], items[int(bounded(quint64(i + 1)))]);
+}
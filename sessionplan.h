@@ -0,0 +1,84 @@
+#ifndef SESSIONPLAN_H
+#define SESSIONPLAN_H
+
+#include <QVector>
+#include <QJsonObject>
+#include <random>
+
+class CompiledQuiz;
+
+// Номера вопросов банка по уровням сложности (1–3; прочие считаются средними,
+// как и при подсчёте времени). Строится один раз, дополняется по мере загрузки.
+class DifficultyIndex
+{
+public:
+    static constexpr int kLevels = 3;
+
+    void append(const CompiledQuiz &quiz, int first, int last);
+    const QVector<int> &level(int difficulty) const { return levels[difficulty - 1]; }
+
+private:
+    QVector<int> levels[kLevels];
+};
+
+// План сессии: порядок вопросов и перестановка вариантов каждого вопроса.
+// План полностью определяется банком, запросом и зерном, поэтому сессию
+// можно проверить и воспроизвести. Генератор — mt19937_64 (его
+// последовательность закреплена стандартом) с собственным равномерным
+// ограничением вместо std::uniform_int_distribution, который у разных
+// стандартных библиотек выдаёт разные числа.
+class SessionPlan
+{
+public:
+    static quint64 randomSeed();
+
+    struct Item
+    {
+        int question = 0;
+        quint8 order[4] = {0, 1, 2, 3};
+    };
+
+    struct Request
+    {
+        quint64 seed = 0;
+        bool sampled = false;
+        int counts[DifficultyIndex::kLevels] = {0, 0, 0};
+        // Срок на каждый вопрос вместо общего срока на всю сессию
+        bool perQuestionLimit = false;
+        // Адаптивный тест: не больше adaptiveLength вопросов, досрочно — когда
+        // стандартная ошибка оценки уровня не больше targetError (0 — до конца)
+        int adaptiveLength = 0;
+        double targetError = 0.0;
+
+        bool adaptive() const { return adaptiveLength > 0; }
+
+        static Request sequential(quint64 seed = randomSeed());
+
+        QJsonObject toJson() const;
+        static Request fromJson(const QJsonObject &obj);
+    };
+
+    SessionPlan() = default;
+    explicit SessionPlan(const Request &request);
+
+    // Все вопросы в порядке файла; дополняется по мере потоковой загрузки
+    void extendSequential(int questionCount);
+    // Выборка без возвращения: O(k) от размера выборки, а не от размера банка
+    void sample(const DifficultyIndex &index);
+    // Следующий вопрос адаптивного теста; варианты перемешиваются тем же генератором
+    void appendQuestion(int question);
+
+    const Request &request() const { return spec; }
+    int count() const { return items.size(); }
+    const Item &item(int position) const { return items[position]; }
+
+private:
+    quint64 bounded(quint64 bound);
+    Item makeItem(int question);
+
+    Request spec;
+    std::mt19937_64 rng;
+    QVector<Item> items;
+};
+
+#endif // SESSIONPLAN_H
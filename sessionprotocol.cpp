@@ -0,0 +1,123 @@
+#include "sessionprotocol.h"
+
+#include <QtEndian>
+
+namespace SessionProtocol
+{
+
+Writer::Writer(MessageType type)
+    : data(kHeaderSize, '\0')
+{
+    data[2] = char(type);
+}
+
+Writer &Writer::u8(quint8 value)
+{
+    data.append(char(value));
+    return *this;
+}
+
+Writer &Writer::u16(quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    data.append(bytes, 2);
+    return *this;
+}
+
+Writer &Writer::i32(qint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    data.append(bytes, 4);
+    return *this;
+}
+
+Writer &Writer::string(const QString &value)
+{
+    // Пять строк вопроса по 8 КБ всегда помещаются в одно сообщение
+    QByteArray utf8 = value.toUtf8();
+    if (utf8.size() > kMaxString)
+        utf8.truncate(kMaxString);
+    u16(quint16(utf8.size()));
+    data.append(utf8);
+    return *this;
+}
+
+QByteArray Writer::frame() const
+{
+    QByteArray message = data;
+    const int payload = qMin(int(message.size()) - kHeaderSize, kMaxPayload);
+    qToLittleEndian(quint16(payload), message.data());
+    message.truncate(kHeaderSize + payload);
+    return message;
+}
+
+bool Reader::take(int size)
+{
+    if (!valid || pos + size > data.size()) {
+        valid = false;
+        return false;
+    }
+    return true;
+}
+
+quint8 Reader::u8()
+{
+    if (!take(1))
+        return 0;
+    return quint8(data[pos++]);
+}
+
+quint16 Reader::u16()
+{
+    if (!take(2))
+        return 0;
+    const quint16 value = qFromLittleEndian<quint16>(data.constData() + pos);
+    pos += 2;
+    return value;
+}
+
+qint32 Reader::i32()
+{
+    if (!take(4))
+        return 0;
+    const qint32 value = qFromLittleEndian<qint32>(data.constData() + pos);
+    pos += 4;
+    return value;
+}
+
+QString Reader::string()
+{
+    const int size = u16();
+    if (!take(size))
+        return QString();
+    const QString value = QString::fromUtf8(data.constData() + pos, size);
+    pos += size;
+    return value;
+}
+
+bool FrameBuffer::next(MessageType *type, QByteArray *payload)
+{
+    if (buffer.size() - pos < kHeaderSize)
+        return false;
+    const int size = qFromLittleEndian<quint16>(buffer.constData() + pos);
+    if (buffer.size() - pos < kHeaderSize + size)
+        return false;
+
+    *type = MessageType(quint8(buffer[pos + 2]));
+    *payload = buffer.mid(pos + kHeaderSize, size);
+    pos += kHeaderSize + size;
+
+    // Разобранное начало сдвигаем не на каждом сообщении, а когда его накопилось много
+    if (pos == buffer.size()) {
+        buffer.clear();
+        pos = 0;
+    } else if (pos > 4096) {
+        buffer.remove(0, pos);
+        pos = 0;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,91 @@
+#ifndef SESSIONPROTOCOL_H
+#define SESSIONPROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// Протокол сессии класса поверх TCP. Сообщение — заголовок из трёх байт
+// (длина тела uint16 little-endian и тип) и тело из полей фиксированной
+// ширины; строки — uint16 длины и UTF-8. Вопрос целиком занимает сотни
+// байт, ответ — 8 байт, поэтому рассылка тысячам клиентов дёшева.
+namespace SessionProtocol
+{
+
+constexpr int kHeaderSize = 3;
+constexpr int kMaxPayload = 0xffff;
+constexpr int kMaxString = 0x1fff;
+
+enum MessageType : quint8 {
+    // Клиент -> сервер
+    Hello = 1,        // имя
+    Answer,           // номер вопроса i32, маска вариантов u8 (в порядке показа)
+    // Сервер -> клиент
+    Welcome = 16,     // название викторины, число вопросов i32
+    QuestionShown,    // номер i32, всего i32, текст, 4 варианта, сложность u8, осталось мс i32
+    AnswerResult,     // номер i32, баллы i32, сумма i32
+    Standings,        // число строк u16, затем имя и баллы i32
+    Finished,         // баллы i32, место i32, участников i32
+    Error             // текст
+};
+
+struct Standing
+{
+    QString name;
+    int score = 0;
+};
+
+// Тело сообщения собирается и читается последовательно
+class Writer
+{
+public:
+    explicit Writer(MessageType type);
+
+    Writer &u8(quint8 value);
+    Writer &u16(quint16 value);
+    Writer &i32(qint32 value);
+    Writer &string(const QString &value);
+
+    // Готовое сообщение с заголовком
+    QByteArray frame() const;
+
+private:
+    QByteArray data;
+};
+
+class Reader
+{
+public:
+    explicit Reader(const QByteArray &payload) : data(payload) {}
+
+    quint8 u8();
+    quint16 u16();
+    qint32 i32();
+    QString string();
+
+    // Ложь, если тело оказалось короче, чем ожидали
+    bool ok() const { return valid; }
+
+private:
+    bool take(int size);
+
+    QByteArray data;
+    int pos = 0;
+    bool valid = true;
+};
+
+// Нарезка входящего потока на сообщения
+class FrameBuffer
+{
+public:
+    void append(const QByteArray &bytes) { buffer += bytes; }
+    bool next(MessageType *type, QByteArray *payload);
+
+private:
+    QByteArray buffer;
+    int pos = 0;
+};
+
+}
+
+#endif // SESSIONPROTOCOL_H
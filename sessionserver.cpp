@@ -0,0 +1,317 @@
+#include "sessionserver.h"
+#include "quizdeltalog.h"
+#include "scoring.h"
+#include "scorestore.h"
+#include "journalline.h"
+#include "leaderboardindex.h"
+
+#include <QFileInfo>
+#include <QTcpSocket>
+
+using namespace SessionProtocol;
+
+namespace {
+const int kStandingsIntervalMs = 500;
+const int kStandingsRows = 10;
+// Ответ, отправленный в последний момент, ещё может быть в пути
+const int kGraceMs = 300;
+const int kMaxNameLength = 64;
+}
+
+SessionServer::SessionServer(QObject *parent)
+    : QObject(parent)
+{
+    server.setMaxPendingConnections(4096);
+    connect(&server, &QTcpServer::newConnection, this, &SessionServer::onNewConnection);
+
+    questionTimer.setSingleShot(true);
+    questionTimer.setTimerType(Qt::PreciseTimer);
+    connect(&questionTimer, &QTimer::timeout, this, &SessionServer::nextQuestion);
+
+    standingsTimer.setInterval(kStandingsIntervalMs);
+    connect(&standingsTimer, &QTimer::timeout, this, &SessionServer::sendStandings);
+}
+
+bool SessionServer::open(const QString &fileName)
+{
+    if (!quiz.open(fileName)) {
+        error = quiz.errorString();
+        return false;
+    }
+    quiz.setOverrides(QuizDeltaLog::read(fileName));
+    quizName = QFileInfo(fileName).fileName();
+    return true;
+}
+
+bool SessionServer::listen(const QHostAddress &address, quint16 port)
+{
+    if (!server.listen(address, port)) {
+        error = server.errorString();
+        return false;
+    }
+    return true;
+}
+
+void SessionServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server.nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        Client client;
+        client.socket = socket;
+        clients.insert(socket, client);
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        // Удаление из таблицы — только из очереди событий, не посреди обхода клиентов
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { onDisconnected(socket); },
+                Qt::QueuedConnection);
+    }
+}
+
+void SessionServer::onReadyRead(QTcpSocket *socket)
+{
+    auto it = clients.find(socket);
+    if (it == clients.end())
+        return;
+
+    it->input.append(socket->readAll());
+    MessageType type;
+    QByteArray payload;
+    while (!it->dropped && it->input.next(&type, &payload))
+        handle(*it, type, payload);
+}
+
+void SessionServer::onDisconnected(QTcpSocket *socket)
+{
+    auto it = clients.find(socket);
+    if (it == clients.end())
+        return;
+
+    const bool wasJoined = it->greeted;
+    const bool answeredCurrent = isRunning() && it->answered == current;
+    clients.erase(it);
+    socket->deleteLater();
+    if (!wasJoined)
+        return;
+
+    --joined;
+    standingsDirty = true;
+    if (answeredCurrent)
+        --answeredCount;
+    emit clientLeft(joined);
+    if (isRunning())
+        checkAllAnswered();
+}
+
+void SessionServer::drop(Client &client, const QString &reason)
+{
+    client.dropped = true;
+    client.socket->write(Writer(Error).string(reason).frame());
+    client.socket->disconnectFromHost();
+}
+
+void SessionServer::handle(Client &client, MessageType type, const QByteArray &payload)
+{
+    Reader reader(payload);
+    switch (type) {
+    case Hello: {
+        const QString name = reader.string().trimmed().left(kMaxNameLength);
+        if (!reader.ok() || client.greeted) {
+            drop(client, "Неверное приветствие");
+            return;
+        }
+        client.name = name;
+        client.greeted = true;
+        ++joined;
+        standingsDirty = true;
+        client.socket->write(Writer(Welcome).string(quizName).i32(quiz.count()).frame());
+        // Опоздавший сразу получает текущий вопрос с оставшимся временем
+        if (isRunning())
+            client.socket->write(questionFrame());
+        emit clientJoined(joined);
+        return;
+    }
+    case Answer: {
+        const int position = reader.i32();
+        const quint8 mask = reader.u8();
+        if (!reader.ok() || !client.greeted) {
+            drop(client, "Неверный ответ");
+            return;
+        }
+        handleAnswer(client, position, mask);
+        return;
+    }
+    default:
+        drop(client, "Неизвестное сообщение");
+        return;
+    }
+}
+
+void SessionServer::handleAnswer(Client &client, int position, quint8 shownMask)
+{
+    // Время считает только сервер: поздний или повторный ответ не принимается
+    if (!isRunning() || position != current || client.answered == current)
+        return;
+    const qint64 now = clock.elapsed();
+    if (now > deadlineMs + kGraceMs)
+        return;
+
+    // Клиент отвечает в порядке показа, баллы считаются в исходном порядке вопроса
+    const SessionPlan::Item &item = plan.item(current);
+    quint8 mask = 0;
+    for (int i = 0; i < Question::kOptionCount; ++i) {
+        if (shownMask & (1u << i))
+            mask |= 1u << item.order[i];
+    }
+    const int points = Scoring::points(shown, mask);
+
+    client.score += points;
+    client.answered = current;
+    client.times.append(int(now - shownAtMs));
+    ScoreRecord::Answer answer;
+    answer.question = item.question;
+    answer.mask = mask;
+    answer.key = shown.correctMask;
+    client.answers.append(answer);
+    client.socket->write(Writer(AnswerResult).i32(current).i32(points).i32(client.score).frame());
+
+    ++answeredCount;
+    standingsDirty = true;
+    checkAllAnswered();
+}
+
+void SessionServer::checkAllAnswered()
+{
+    if (joined > 0 && answeredCount >= joined)
+        nextQuestion();
+}
+
+void SessionServer::startSession(quint64 seed)
+{
+    if (isRunning() || quiz.count() == 0)
+        return;
+
+    plan = SessionPlan(SessionPlan::Request::sequential(seed));
+    plan.extendSequential(quiz.count());
+    for (Client &client : clients) {
+        client.score = 0;
+        client.answered = -1;
+        client.times.clear();
+        client.answers.clear();
+    }
+    current = -1;
+    finished = false;
+    clock.start();
+    standingsTimer.start();
+    nextQuestion();
+}
+
+void SessionServer::nextQuestion()
+{
+    questionTimer.stop();
+    if (finished)
+        return;
+
+    if (++current >= plan.count()) {
+        finishSession();
+        return;
+    }
+
+    shown = quiz.question(plan.item(current).question);
+    const qint64 limitMs = qint64(Scoring::secondsFor(shown.difficulty)) * 1000;
+    shownAtMs = clock.elapsed();
+    deadlineMs = shownAtMs + limitMs;
+    answeredCount = 0;
+    questionTimer.start(int(limitMs + kGraceMs));
+
+    // Сообщение собирается один раз и одинаково для всех
+    broadcast(questionFrame());
+    emit questionStarted(current);
+}
+
+qint64 SessionServer::remainingMs() const
+{
+    return qMax<qint64>(0, deadlineMs - clock.elapsed());
+}
+
+QByteArray SessionServer::questionFrame() const
+{
+    const SessionPlan::Item &item = plan.item(current);
+    Writer writer(QuestionShown);
+    writer.i32(current).i32(plan.count()).string(shown.text);
+    for (int i = 0; i < Question::kOptionCount; ++i)
+        writer.string(shown.options[item.order[i]]);
+    writer.u8(shown.difficulty).i32(qint32(remainingMs()));
+    return writer.frame();
+}
+
+void SessionServer::broadcast(const QByteArray &frame)
+{
+    for (Client &client : clients) {
+        if (client.greeted && !client.dropped)
+            client.socket->write(frame);
+    }
+}
+
+void SessionServer::sendStandings()
+{
+    if (!standingsDirty)
+        return;
+    standingsDirty = false;
+
+    QVector<const Client *> joinedClients;
+    LeaderboardIndex board;
+    for (const Client &client : clients) {
+        if (!client.greeted)
+            continue;
+        board.insert(joinedClients.size(), client.score);
+        joinedClients.append(&client);
+    }
+
+    const int rows = qMin(kStandingsRows, board.count());
+    Writer writer(Standings);
+    writer.u16(quint16(rows));
+    for (int row = 0; row < rows; ++row) {
+        const Client *client = joinedClients[board.recordAt(row)];
+        writer.string(client->name).i32(client->score);
+    }
+    broadcast(writer.frame());
+}
+
+void SessionServer::finishSession()
+{
+    finished = true;
+    questionTimer.stop();
+    standingsTimer.stop();
+    standingsDirty = true;
+    sendStandings();
+
+    // Для места нужны только баллы, номера записей не используются
+    LeaderboardIndex board;
+    for (const Client &client : clients) {
+        if (client.greeted)
+            board.insert(board.count(), client.score);
+    }
+
+    QByteArray lines;
+    for (Client &client : clients) {
+        if (!client.greeted)
+            continue;
+        client.socket->write(Writer(Finished).i32(client.score).i32(board.rankOf(client.score)).i32(board.count()).frame());
+        client.socket->disconnectFromHost();
+
+        if (saveResults && !client.name.isEmpty()) {
+            ScoreRecord record;
+            record.name = client.name;
+            record.quiz = quizName;
+            record.score = client.score;
+            record.plan = plan.request().toJson();
+            record.times = client.times;
+            record.answers = client.answers;
+            lines += JournalLine::encode(record.toJson());
+        }
+    }
+
+    if (!lines.isEmpty() && !ScoreJournal(ScoreJournal::defaultPath()).appendBatch(lines))
+        error = "Не удалось записать результаты в журнал";
+    emit sessionFinished();
+}
@@ -0,0 +1,102 @@
+#ifndef SESSIONSERVER_H
+#define SESSIONSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QHostAddress>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "quizsource.h"
+#include "sessionplan.h"
+#include "sessionprotocol.h"
+#include "scorestore.h"
+
+class QTcpSocket;
+
+// Сервер сессии класса: одна викторина для всех подключённых, вопросы идут
+// синхронно. Срок вопроса задаёт сервер по сложности (Scoring::secondsFor),
+// клиенту отправляется только оставшееся время; ответы после срока не
+// принимаются. Следующий вопрос показывается по истечении срока или когда
+// ответили все. Весь ввод-вывод — события одного потока, без потока на
+// клиента. Таблица лидеров рассылается не чаще kStandingsIntervalMs.
+class SessionServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionServer(QObject *parent = nullptr);
+
+    bool open(const QString &fileName);
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0);
+    QString errorString() const { return error; }
+    quint16 port() const { return server.serverPort(); }
+
+    int clientCount() const { return joined; }
+    int questionCount() const { return plan.count(); }
+    bool isRunning() const { return current >= 0 && !finished; }
+
+    // Результаты с именами дописываются в журнал scores.d/ по окончании
+    void setSaveResults(bool save) { saveResults = save; }
+
+public slots:
+    void startSession(quint64 seed = SessionPlan::randomSeed());
+
+signals:
+    void clientJoined(int count);
+    void clientLeft(int count);
+    void questionStarted(int position);
+    void sessionFinished();
+
+private:
+    struct Client
+    {
+        QTcpSocket *socket = nullptr;
+        SessionProtocol::FrameBuffer input;
+        QString name;
+        bool greeted = false;
+        bool dropped = false;
+        int score = 0;
+        int answered = -1;
+        QVector<int> times;
+        QVector<ScoreRecord::Answer> answers;
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    void onDisconnected(QTcpSocket *socket);
+    void handle(Client &client, SessionProtocol::MessageType type, const QByteArray &payload);
+    void handleAnswer(Client &client, int position, quint8 shownMask);
+
+    void nextQuestion();
+    void finishSession();
+    void broadcast(const QByteArray &frame);
+    void sendStandings();
+    QByteArray questionFrame() const;
+    qint64 remainingMs() const;
+    void checkAllAnswered();
+    void drop(Client &client, const QString &reason);
+
+    QTcpServer server;
+    QString error;
+    QString quizName;
+    QuizSource quiz;
+    SessionPlan plan;
+    QHash<QTcpSocket *, Client> clients;
+    int joined = 0;
+
+    int current = -1;
+    bool finished = false;
+    Question shown;
+    QElapsedTimer clock;
+    qint64 deadlineMs = 0;
+    qint64 shownAtMs = 0;
+    int answeredCount = 0;
+    QTimer questionTimer;
+    QTimer standingsTimer;
+    bool standingsDirty = false;
+    bool saveResults = true;
+};
+
+#endif // SESSIONSERVER_H
@@ -0,0 +1,50 @@
+#include "startupprofiler.h"
+
+#include <QEvent>
+#include <QWidget>
+#include <QTextStream>
+
+StartupProfiler *StartupProfiler::instance()
+{
+    // Живёт до конца процесса: создаётся раньше QApplication
+    static StartupProfiler *profiler = new StartupProfiler;
+    return profiler;
+}
+
+StartupProfiler::StartupProfiler()
+{
+    clock.start();
+}
+
+void StartupProfiler::mark(const QString &phase)
+{
+    marks.append(qMakePair(phase, clock.nsecsElapsed()));
+}
+
+void StartupProfiler::watchFirstFrame(QWidget *window)
+{
+    window->installEventFilter(this);
+}
+
+bool StartupProfiler::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Paint) {
+        watched->removeEventFilter(this);
+        mark("первый кадр");
+        emit firstFrame();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void StartupProfiler::report() const
+{
+    QTextStream err(stderr);
+    qint64 previous = 0;
+    for (const auto &entry : marks) {
+        err << QString("%1 мс  (+%2 мс)  %3\n")
+                   .arg(entry.second / 1e6, 8, 'f', 2)
+                   .arg((entry.second - previous) / 1e6, 7, 'f', 2)
+                   .arg(entry.first);
+        previous = entry.second;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QPair>
+#include <QString>
+
+class QWidget;
+
+// Отметки фаз запуска приложения. Часы стартуют при первом обращении к
+// instance() в начале main(); с ключом --profile-startup после первого
+// кадра главного окна таблица фаз печатается в stderr.
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StartupProfiler *instance();
+
+    void mark(const QString &phase);
+    void watchFirstFrame(QWidget *window);
+    void report() const;
+
+signals:
+    void firstFrame();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    StartupProfiler();
+
+    QElapsedTimer clock;
+    QVector<QPair<QString, qint64>> marks;
+};
+
+#endif // STARTUPPROFILER_H
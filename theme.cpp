@@ -0,0 +1,268 @@
+#include "theme.h"
+
+#include <QAbstractScrollArea>
+#include <QApplication>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPainter>
+#include <QPainterPath>
+#include <QProxyStyle>
+#include <QPushButton>
+#include <QRadioButton>
+#include <QStyleFactory>
+#include <QStyleOption>
+
+namespace
+{
+
+// Вид виджетов одного окна. Невалидный цвет или нулевой размер — оставить
+// как у Fusion
+struct Look
+{
+    const char *window;
+    QColor background;
+    int fontPx;
+
+    QColor list;          // фон списков и таблиц
+    QColor listBorder;
+    QColor edit;          // фон однострочных полей и выпадающих списков
+    QColor editBorder;
+    int editPadding;
+
+    QColor labelColor;
+    int labelPx;
+    int labelMargin;
+    QColor checkColor;
+    int checkPx;
+    int checkMargin;
+    QColor radioColor;
+
+    bool onlyMainButtons; // в главном окне оформлены только кнопки mainButton
+    QColor button;
+    QColor buttonHover;
+    bool buttonBold;
+    int buttonPx;
+    int buttonPadV;
+    int buttonPadH;
+};
+
+const QColor kPink(0xff, 0xe4, 0xf0);
+const QColor kField(0xff, 0xf0, 0xf8);
+const QColor kBorder(0xff, 0xaa, 0xd4);
+const QColor kButton(0xff, 0xaa, 0xd4);
+const QColor kHover(0xff, 0x8f, 0xb6);
+const QColor kAccent(0xd8, 0x1b, 0x60);
+const QColor kNone;
+
+const Look kLooks[] = {
+    {"MainWindow", QColor(0xff, 0xc0, 0xcb), 0,
+     kNone, kNone, kNone, kNone, 0,
+     kNone, 0, 0, kNone, 0, 0, kNone,
+     true, QColor(0xff, 0x69, 0xb4), QColor(0xff, 0x69, 0xb4), false, 0, 10, 10},
+    {"QuizEditor", kPink, 0,
+     kField, kBorder, kField, kBorder, 4,
+     kNone, 0, 0, kNone, 0, 0, kAccent,
+     false, kButton, kHover, true, 0, 6, 6},
+    {"QuizViewer", kPink, 16,
+     kField, kBorder, Qt::white, kNone, 6,
+     kNone, 0, 0, kNone, 0, 0, kNone,
+     false, kButton, kHover, true, 0, 8, 16},
+    {"QuizTaker", kPink, 18,
+     kPink, kNone, kNone, kNone, 0,
+     kAccent, 22, 8, QColor(0x6a, 0x1b, 0x9a), 20, 6, kNone,
+     false, kButton, kHover, true, 20, 12, 20},
+    {"QuizLibrary", kPink, 0,
+     kField, kBorder, kNone, kNone, 0,
+     kNone, 0, 0, kNone, 0, 0, kNone,
+     false, kButton, kHover, true, 0, 6, 16},
+};
+
+const Look *lookFor(const QWidget *widget)
+{
+    const QWidget *window = widget->window();
+    for (const Look &look : kLooks) {
+        if (window->inherits(look.window))
+            return &look;
+    }
+    return nullptr;
+}
+
+QFont themeFont(QFont font, int pixelSize, bool bold)
+{
+    font.setFamily("Segoe UI");
+    font.setStyleHint(QFont::SansSerif);
+    if (pixelSize > 0)
+        font.setPixelSize(pixelSize);
+    font.setBold(bold);
+    return font;
+}
+
+// Параметры рисования хранятся в свойствах виджета, их выставляет polish
+const char kButtonColor[] = "themeButton";
+const char kButtonHover[] = "themeHover";
+const char kButtonPadding[] = "themePadding";
+const char kFieldColor[] = "themeField";
+const char kFieldBorder[] = "themeBorder";
+
+void fillRounded(QPainter *painter, const QRectF &rect, qreal radius, const QColor &fill,
+                 const QPen &pen)
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    QPainterPath path;
+    path.addRoundedRect(rect, radius, radius);
+    if (fill.isValid())
+        painter->fillPath(path, fill);
+    if (pen.style() != Qt::NoPen)
+        painter->strokePath(path, pen);
+    painter->restore();
+}
+
+class ThemeStyle : public QProxyStyle
+{
+public:
+    ThemeStyle() : QProxyStyle(QStyleFactory::create("Fusion")) {}
+
+    using QProxyStyle::polish;
+    void polish(QWidget *widget) override;
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter,
+                       const QWidget *widget) const override;
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                     const QWidget *widget) const override;
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option, const QSize &size,
+                           const QWidget *widget) const override;
+};
+
+void ThemeStyle::polish(QWidget *widget)
+{
+    QProxyStyle::polish(widget);
+    const Look *look = lookFor(widget);
+    if (!look)
+        return;
+
+    QPalette palette = widget->palette();
+    if (widget->isWindow()) {
+        palette.setColor(QPalette::Window, look->background);
+        widget->setPalette(palette);
+        if (!look->onlyMainButtons)
+            widget->setFont(themeFont(widget->font(), look->fontPx, false));
+        return;
+    }
+
+    if (auto *button = qobject_cast<QPushButton *>(widget)) {
+        if (look->onlyMainButtons && button->objectName() != "mainButton")
+            return;
+        button->setAttribute(Qt::WA_Hover);
+        button->setProperty(kButtonColor, look->button);
+        button->setProperty(kButtonHover, look->buttonHover);
+        button->setProperty(kButtonPadding, QSize(look->buttonPadH, look->buttonPadV));
+        palette.setColor(QPalette::ButtonText, Qt::white);
+        button->setPalette(palette);
+        if (look->buttonBold || look->buttonPx > 0)
+            button->setFont(themeFont(button->font(), look->buttonPx, look->buttonBold));
+    } else if (auto *label = qobject_cast<QLabel *>(widget)) {
+        if (!look->labelColor.isValid())
+            return;
+        palette.setColor(QPalette::WindowText, look->labelColor);
+        label->setPalette(palette);
+        label->setFont(themeFont(label->font(), look->labelPx, true));
+        label->setMargin(look->labelMargin);
+    } else if (auto *check = qobject_cast<QCheckBox *>(widget)) {
+        if (!look->checkColor.isValid())
+            return;
+        palette.setColor(QPalette::WindowText, look->checkColor);
+        check->setPalette(palette);
+        check->setFont(themeFont(check->font(), look->checkPx, false));
+        check->setContentsMargins(look->checkMargin, look->checkMargin, look->checkMargin,
+                                  look->checkMargin);
+    } else if (auto *radio = qobject_cast<QRadioButton *>(widget)) {
+        if (!look->radioColor.isValid())
+            return;
+        palette.setColor(QPalette::WindowText, look->radioColor);
+        radio->setPalette(palette);
+    } else if (auto *edit = qobject_cast<QLineEdit *>(widget)) {
+        if (!look->edit.isValid())
+            return;
+        edit->setProperty(kFieldColor, look->edit);
+        edit->setProperty(kFieldBorder, look->editBorder);
+        edit->setTextMargins(look->editPadding, look->editPadding, look->editPadding,
+                             look->editPadding);
+    } else if (auto *combo = qobject_cast<QComboBox *>(widget)) {
+        if (!look->edit.isValid())
+            return;
+        palette.setColor(QPalette::Button, look->edit);
+        palette.setColor(QPalette::Base, look->edit);
+        combo->setPalette(palette);
+    } else if (auto *area = qobject_cast<QAbstractScrollArea *>(widget)) {
+        if (!look->list.isValid())
+            return;
+        palette.setColor(QPalette::Base, look->list);
+        palette.setColor(QPalette::Highlight, kButton);
+        area->setPalette(palette);
+        area->setProperty(kFieldBorder, look->listBorder);
+    }
+}
+
+void ThemeStyle::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
+                               QPainter *painter, const QWidget *widget) const
+{
+    if (widget && element == PE_PanelButtonCommand) {
+        const QVariant color = widget->property(kButtonColor);
+        if (color.isValid()) {
+            const bool hover = option->state & State_MouseOver;
+            const QColor fill = widget->property(hover ? kButtonHover : kButtonColor).value<QColor>();
+            fillRounded(painter, QRectF(option->rect).adjusted(1, 1, -1, -1), 10, fill,
+                        QPen(Qt::white, 2));
+            return;
+        }
+    }
+    if (widget && element == PE_FrameFocusRect && widget->property(kButtonColor).isValid())
+        return;
+    if (widget && element == PE_PanelLineEdit) {
+        const QVariant color = widget->property(kFieldColor);
+        if (color.isValid()) {
+            const QColor border = widget->property(kFieldBorder).value<QColor>();
+            fillRounded(painter, QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5), 6,
+                        color.value<QColor>(), border.isValid() ? QPen(border, 1) : QPen(Qt::NoPen));
+            return;
+        }
+    }
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void ThemeStyle::drawControl(ControlElement element, const QStyleOption *option,
+                             QPainter *painter, const QWidget *widget) const
+{
+    if (widget && element == CE_ShapedFrame) {
+        const QColor border = widget->property(kFieldBorder).value<QColor>();
+        if (border.isValid()) {
+            fillRounded(painter, QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5), 6, QColor(),
+                        QPen(border, 1));
+            return;
+        }
+    }
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+QSize ThemeStyle::sizeFromContents(ContentsType type, const QStyleOption *option,
+                                   const QSize &size, const QWidget *widget) const
+{
+    if (widget && type == CT_PushButton) {
+        const QVariant padding = widget->property(kButtonPadding);
+        if (padding.isValid()) {
+            // Как в CSS: содержимое, отступы и рамка 2px с каждой стороны
+            const QSize pad = padding.toSize();
+            return QSize(size.width() + 2 * pad.width() + 4, size.height() + 2 * pad.height() + 4);
+        }
+    }
+    return QProxyStyle::sizeFromContents(type, option, size, widget);
+}
+
+} // namespace
+
+void Theme::apply(QApplication &app)
+{
+    app.setStyle(new ThemeStyle);
+}
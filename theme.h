@@ -0,0 +1,16 @@
+#ifndef THEME_H
+#define THEME_H
+
+class QApplication;
+
+// Оформление всех окон задаётся стилем приложения: QProxyStyle поверх Fusion
+// рисует закруглённые кнопки и поля, а цвета и шрифты раздаются палитрой при
+// полировке виджета по классу его окна. Таблица стилей не используется: с ней
+// Qt оборачивает стиль каждого виджета в QStyleSheetStyle, который сопоставляет
+// правила при создании окна и заново при каждой перерисовке.
+namespace Theme
+{
+void apply(QApplication &app);
+}
+
+#endif // THEME_H